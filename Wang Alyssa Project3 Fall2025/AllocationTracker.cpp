@@ -0,0 +1,71 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "AllocationTracker.h"
+#include <cstdlib>
+#include <new>
+
+// Plain-old-data so it is safe to touch from operator new at any point in a thread's life.
+static thread_local AllocationStats threadStats;
+
+static void* Allocate(std::size_t size) {
+    threadStats.allocations++;
+    threadStats.bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+    threadStats.allocations++;
+    threadStats.bytes += size;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+AllocationStats AllocationTracker::ThreadStats() {
+    return threadStats;
+}
+
+AllocationStats AllocationTracker::Since(const AllocationStats& start) {
+    AllocationStats now = threadStats;
+    return {now.allocations - start.allocations, now.bytes - start.bytes};
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = Allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = Allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = AllocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = AllocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,32 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_ALLOCATIONTRACKER_H
+#define MINESWEEPER_ALLOCATIONTRACKER_H
+
+#include <cstdint>
+
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+// Counts heap allocations made through the replaceable global operator new on the calling
+// thread. Take a snapshot before and after a frame or game action and subtract. Builds
+// without MINESWEEPER_METRICS leave operator new alone and always report zero.
+#ifdef MINESWEEPER_METRICS
+class AllocationTracker {
+public:
+    static AllocationStats ThreadStats();
+    static AllocationStats Since(const AllocationStats& start);
+};
+#else
+class AllocationTracker {
+public:
+    static AllocationStats ThreadStats() { return {}; }
+    static AllocationStats Since(const AllocationStats&) { return {}; }
+};
+#endif
+
+#endif
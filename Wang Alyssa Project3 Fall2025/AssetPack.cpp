@@ -0,0 +1,84 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "AssetPack.h"
+#include <cstring>
+#include <iostream>
+
+extern const unsigned char EMBEDDED_ASSETS[];
+extern const size_t EMBEDDED_ASSETS_SIZE;
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+const AssetPack& AssetPack::Embedded() {
+    static const AssetPack pack = []() {
+        AssetPack embedded;
+        if (!embedded.Load(EMBEDDED_ASSETS, EMBEDDED_ASSETS_SIZE)) {
+            std::cerr << "Error: Embedded asset pack is corrupt!" << std::endl;
+        }
+        return embedded;
+    }();
+    return pack;
+}
+
+bool AssetPack::Decompress(const unsigned char* data, size_t size, std::vector<unsigned char>& raw) {
+    if (size < 8 || std::memcmp(data, ASSET_PACK_MAGIC, 4) != 0) return false;
+    size_t rawSize = ReadU32(data + 4);
+    raw.clear();
+    raw.reserve(rawSize);
+
+    size_t pos = 8;
+    while (raw.size() < rawSize && pos < size) {
+        unsigned char flags = data[pos++];
+        for (int bit = 0; bit < 8 && raw.size() < rawSize; ++bit) {
+            if (flags & (1 << bit)) {
+                if (pos >= size) return false;
+                raw.push_back(data[pos++]);
+            } else {
+                if (pos + 2 > size) return false;
+                int token = data[pos] | (data[pos + 1] << 8);
+                pos += 2;
+                size_t offset = (token & 0x0FFF) + 1;
+                int length = (token >> 12) + LZ_MIN_MATCH;
+                if (offset > raw.size()) return false;
+                for (int i = 0; i < length; ++i) {
+                    raw.push_back(raw[raw.size() - offset]);
+                }
+            }
+        }
+    }
+    return raw.size() == rawSize;
+}
+
+bool AssetPack::Load(const unsigned char* compressed, size_t size) {
+    entries.clear();
+    if (!Decompress(compressed, size, blob) || blob.size() < 4) return false;
+
+    size_t pos = 4;
+    uint32_t count = ReadU32(blob.data());
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + 4 > blob.size()) return false;
+        uint32_t nameLength = ReadU32(blob.data() + pos);
+        pos += 4;
+        if (pos + nameLength + 8 > blob.size()) return false;
+        std::string name(reinterpret_cast<const char*>(blob.data() + pos), nameLength);
+        pos += nameLength;
+        size_t offset = ReadU32(blob.data() + pos);
+        size_t length = ReadU32(blob.data() + pos + 4);
+        pos += 8;
+        if (offset + length > blob.size()) return false;
+        entries[name] = {offset, length};
+    }
+    return true;
+}
+
+bool AssetPack::Find(const std::string& name, const unsigned char*& data, size_t& size) const {
+    auto it = entries.find(name);
+    if (it == entries.end()) return false;
+    data = blob.data() + it->second.first;
+    size = it->second.second;
+    return true;
+}
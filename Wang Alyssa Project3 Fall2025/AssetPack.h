@@ -0,0 +1,37 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_ASSETPACK_H
+#define MINESWEEPER_ASSETPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Images and the font are packed by AssetPacker at build time into one LZSS-compressed
+// blob that is linked into the executable. Layout after decompression:
+//   u32 entryCount, then per entry: u32 nameLength, name, u32 offset, u32 size; then the data.
+// The compressed blob starts with ASSET_PACK_MAGIC and the u32 decompressed size.
+class AssetPack {
+public:
+    static constexpr char ASSET_PACK_MAGIC[4] = {'M', 'S', 'A', 'P'};
+    static const int LZ_WINDOW = 4096;
+    static const int LZ_MIN_MATCH = 3;
+    static const int LZ_MAX_MATCH = 18;
+
+    static const AssetPack& Embedded();
+
+    bool Load(const unsigned char* compressed, size_t size);
+    bool Find(const std::string& name, const unsigned char*& data, size_t& size) const;
+
+private:
+    std::vector<unsigned char> blob;
+    std::map<std::string, std::pair<size_t, size_t>> entries;
+
+    static bool Decompress(const unsigned char* data, size_t size, std::vector<unsigned char>& raw);
+};
+
+#endif
@@ -0,0 +1,116 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// Build-time tool: AssetPacker <output.cpp> <root dir> <file>...
+// Packs the given files (paths relative to the root dir) into the compressed format read by
+// AssetPack and writes them out as a C++ byte array.
+
+#include "AssetPack.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+static void WriteU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back((unsigned char)(value >> (8 * i)));
+}
+
+static std::vector<unsigned char> Compress(const std::vector<unsigned char>& raw) {
+    std::vector<unsigned char> out(AssetPack::ASSET_PACK_MAGIC, AssetPack::ASSET_PACK_MAGIC + 4);
+    WriteU32(out, (uint32_t)raw.size());
+
+    // Hash chains over 3-byte prefixes, limited to a few probes per position.
+    const int HASH_SIZE = 1 << 14;
+    std::vector<int> head(HASH_SIZE, -1);
+    std::vector<int> previous(raw.size(), -1);
+    auto hashAt = [&raw](size_t i) { return ((raw[i] << 6) ^ (raw[i + 1] << 3) ^ raw[i + 2]) & (HASH_SIZE - 1); };
+    auto insert = [&](size_t i) {
+        if (i + 2 >= raw.size()) return;
+        int h = hashAt(i);
+        previous[i] = head[h];
+        head[h] = (int)i;
+    };
+
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        size_t flagPos = out.size();
+        out.push_back(0);
+        for (int bit = 0; bit < 8 && pos < raw.size(); ++bit) {
+            int bestLength = 0;
+            size_t bestOffset = 0;
+            if (pos + 2 < raw.size()) {
+                int candidate = head[hashAt(pos)];
+                for (int probes = 0; candidate >= 0 && probes < 32; ++probes, candidate = previous[candidate]) {
+                    size_t offset = pos - candidate;
+                    if (offset > (size_t)AssetPack::LZ_WINDOW) break;
+                    int length = 0;
+                    while (length < AssetPack::LZ_MAX_MATCH && pos + length < raw.size() && raw[candidate + length] == raw[pos + length]) {
+                        ++length;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestOffset = offset;
+                    }
+                }
+            }
+
+            if (bestLength >= AssetPack::LZ_MIN_MATCH) {
+                int token = (int)(bestOffset - 1) | ((bestLength - AssetPack::LZ_MIN_MATCH) << 12);
+                out.push_back((unsigned char)(token & 0xFF));
+                out.push_back((unsigned char)(token >> 8));
+                for (int i = 0; i < bestLength; ++i) insert(pos++);
+            } else {
+                out[flagPos] |= (unsigned char)(1 << bit);
+                out.push_back(raw[pos]);
+                insert(pos++);
+            }
+        }
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: AssetPacker <output.cpp> <root dir> <file>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names(argv + 3, argv + argc);
+    std::vector<std::vector<unsigned char>> contents;
+    for (const std::string& name : names) {
+        std::ifstream file(std::string(argv[2]) + "/" + name, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open " << name << "!" << std::endl;
+            return 1;
+        }
+        contents.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<unsigned char> raw;
+    WriteU32(raw, (uint32_t)names.size());
+    size_t dataOffset = 4;
+    for (const std::string& name : names) dataOffset += 4 + name.size() + 8;
+    for (size_t i = 0; i < names.size(); ++i) {
+        WriteU32(raw, (uint32_t)names[i].size());
+        raw.insert(raw.end(), names[i].begin(), names[i].end());
+        WriteU32(raw, (uint32_t)dataOffset);
+        WriteU32(raw, (uint32_t)contents[i].size());
+        dataOffset += contents[i].size();
+    }
+    for (const auto& content : contents) raw.insert(raw.end(), content.begin(), content.end());
+
+    std::vector<unsigned char> packed = Compress(raw);
+
+    std::ofstream out(argv[1]);
+    out << "// Generated by AssetPacker. Do not edit.\n";
+    out << "#include <cstddef>\n\n";
+    out << "extern const unsigned char EMBEDDED_ASSETS[] = {";
+    for (size_t i = 0; i < packed.size(); ++i) {
+        out << (i % 16 == 0 ? "\n    " : " ") << (int)packed[i] << ",";
+    }
+    out << "\n};\n";
+    out << "extern const std::size_t EMBEDDED_ASSETS_SIZE = " << packed.size() << ";\n";
+
+    std::cout << "Packed " << names.size() << " assets: " << raw.size() << " -> " << packed.size() << " bytes" << std::endl;
+    return out.good() ? 0 : 1;
+}
@@ -4,201 +4,195 @@
 
 #include "Board.h"
 #include "TextureManager.h"
-#include <random>
+#include "Metrics.h"
+#include "Trace.h"
 #include <chrono>
 #include <algorithm>
 #include <iostream>
 
+static_assert(Board::PLAYING == (int)MineField::PLAYING && Board::WIN == (int)MineField::WIN && Board::LOSE == (int)MineField::LOSE,
+              "Board mirrors the field's game state");
+
 Board::Board() {}
 
-bool Board::GetTileIndices(float x, float y, int& col, int& row) {
-    col = static_cast<int>(x / 32.0f);
-    row = static_cast<int>(y / 32.0f);
-    return (col >= 0 && col < columns && row >= 0 && row < rows);
+sf::Vector2f Board::PixelToWorld(float x, float y) const {
+    sf::Vector2f normalized(2.0f * x / viewportSize.x - 1.0f, 1.0f - 2.0f * y / viewportSize.y);
+    return view.getInverseTransform().transformPoint(normalized);
 }
 
-std::vector<Tile*> Board::GetNeighbors(int col, int row) {
-    std::vector<Tile*> neighbors;
-    for (int dc = -1; dc <= 1; ++dc) {
-        for (int dr = -1; dr <= 1; ++dr) {
-            if (dc == 0 && dr == 0) continue;
-            int neighborCol = col + dc;
-            int neighborRow = row + dr;
-            if (neighborCol >= 0 && neighborCol < columns && neighborRow >= 0 && neighborRow < rows) {
-                neighbors.push_back(&grid[neighborRow][neighborCol]);
-            }
-        }
-    }
-    return neighbors;
+int Board::GetCellAt(float x, float y) const {
+    sf::Vector2f world = PixelToWorld(x, y);
+    if (world.x < 0.0f || world.y < 0.0f) return -1;
+    int col = static_cast<int>(world.x / 32.0f);
+    int row = static_cast<int>(world.y / 32.0f);
+    if (col >= columns || row >= rows) return -1;
+    return row * columns + col;
 }
 
-void Board::Initialize(int cols, int rows, int mines, TextureManager& textures) {
-    columns = cols;
-    this->rows = rows;
-    totalMines = mines;
-    totalTiles = cols * rows;
-    tilesRevealed = 0;
-    currentState = PLAYING;
-    flagsPlaced = 0;
-    debugMode = false;
-    leaderboardShown = false;
-
-    grid.clear();
-    grid.resize(rows);
-    for (int r = 0; r < rows; ++r) {
-        grid[r].reserve(columns);
-        for (int c = 0; c < columns; ++c) {
-            grid[r].emplace_back(c, r, textures);
-            grid[r][c].SetPosition((float)c * 32.0f, (float)r * 32.0f);
-        }
-    }
+void Board::SetViewport(float width, float height, float windowHeight) {
+    viewportSize = {width, height};
+    this->windowHeight = windowHeight;
+    ResetView();
+}
 
-    PlaceMines(mines);
-    SetupNeighbors();
-    CalculateAdjacentMines();
+void Board::ResetView() {
+    view = sf::View(sf::FloatRect({0.0f, 0.0f}, viewportSize));
+    view.setViewport(sf::FloatRect({0.0f, 0.0f}, {1.0f, viewportSize.y / windowHeight}));
+    ClampView();
 }
 
-void Board::Restart(TextureManager& textures) {
-    Initialize(columns, rows, totalMines, textures);
+void Board::Zoom(float factor, float x, float y) {
+    sf::Vector2f before = PixelToWorld(x, y);
+    view.zoom(factor);
+
+    // Keep the zoom between 4x magnified and the whole board fitting on screen.
+    float boardFit = std::max(columns * 32.0f / viewportSize.x, rows * 32.0f / viewportSize.y);
+    float scale = std::clamp(view.getSize().x / viewportSize.x, 0.25f, std::max(1.0f, boardFit));
+    view.setSize(viewportSize * scale);
+
+    view.move(before - PixelToWorld(x, y));
+    ClampView();
 }
 
-void Board::PlaceMines(int mineCount) {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 generator(seed);
+void Board::Pan(float dx, float dy) {
+    float scale = view.getSize().x / viewportSize.x;
+    view.move({dx * scale, dy * scale});
+    ClampView();
+}
 
-    std::vector<int> tileIndices(totalTiles);
-    for (int i = 0; i < totalTiles; ++i) tileIndices[i] = i;
-    std::shuffle(tileIndices.begin(), tileIndices.end(), generator);
+void Board::ClampView() {
+    sf::Vector2f boardSize(columns * 32.0f, rows * 32.0f);
+    sf::Vector2f half = view.getSize() / 2.0f;
+    sf::Vector2f center = view.getCenter();
 
-    for (int i = 0; i < mineCount; ++i) {
-        int index = tileIndices[i];
-        grid[index / columns][index % columns].isMine = true;
-    }
+    center.x = (half.x * 2.0f >= boardSize.x) ? half.x : std::clamp(center.x, half.x, boardSize.x - half.x);
+    center.y = (half.y * 2.0f >= boardSize.y) ? half.y : std::clamp(center.y, half.y, boardSize.y - half.y);
+    view.setCenter(center);
 }
 
-void Board::SetupNeighbors() {
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < columns; ++c) {
-            std::vector<Tile*> neighbors = GetNeighbors(c, r);
-            for (Tile* neighbor : neighbors) {
-                grid[r][c].AddNeighbor(neighbor);
-            }
-        }
-    }
+void Board::Initialize(int cols, int rows, int mines, unsigned long long seed) {
+    TRACE_SCOPE("Board::Initialize");
+    METRIC_TIME_SCOPE(INITIALIZE_MICROS);
+    METRIC_ADD(INITIALIZE_COUNT, 1);
+    columns = cols;
+    this->rows = rows;
+    debugMode = false;
+    leaderboardShown = false;
+    fixedSeed = seed;
+    if (seed == 0) seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+    field.Initialize(cols, rows, mines, seed);
+    METRIC_ADD(MINES_PLACED, mines);
+    currentState = PLAYING;
+    flagsPlaced = 0;
+
+    chunkCache.Reset(columns, rows);
+    pausedCover.setSize({columns * 32.0f, rows * 32.0f});
+    pausedCover.setTextureRect(sf::IntRect({0, 0}, {columns * 32, rows * 32}));
+    if (windowHeight > 0.0f) ResetView();
 }
 
-void Board::CalculateAdjacentMines() {
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < columns; ++c) {
-            if (grid[r][c].isMine) continue;
-            int count = 0;
-            for (Tile* neighbor : grid[r][c].adjacentTiles) {
-                if (neighbor->isMine) count++;
-            }
-            grid[r][c].adjacentMines = count;
-        }
-    }
+void Board::Restart() {
+    METRIC_TIME_SCOPE(RESTART_MICROS);
+    METRIC_ADD(RESTART_COUNT, 1);
+    Initialize(columns, rows, field.GetTotalMines(), fixedSeed);
 }
 
 void Board::Draw(sf::RenderWindow& window, bool paused, TextureManager& textures) {
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < columns; ++c) {
-            if (paused) {
-                sf::Sprite temp = grid[r][c].sprite;
-                temp.setTexture(textures.GetTexture("tile_revealed.png"));
-                window.draw(temp);
-            } else {
-                grid[r][c].UpdateTexture(textures);
-                window.draw(grid[r][c].sprite);
-
-                sf::Sprite overlaySprite(textures.GetTexture("tile_hidden.png"));
-                overlaySprite.setPosition(grid[r][c].sprite.getPosition());
-
-                if (!grid[r][c].isRevealed) {
-                    if (grid[r][c].hasFlag) {
-                        overlaySprite.setTexture(textures.GetTexture("flag.png"));
-                        window.draw(overlaySprite);
-                    }
-                    else if (debugMode && grid[r][c].isMine) {
-                        overlaySprite.setTexture(textures.GetTexture("mine.png"));
-                        window.draw(overlaySprite);
-                    }
-                }
-                else {
-                    if (grid[r][c].isMine) {
-                        overlaySprite.setTexture(textures.GetTexture("mine.png"));
-                        window.draw(overlaySprite);
-                    }
-                    else if (grid[r][c].adjacentMines > 0) {
-                        overlaySprite.setTexture(textures.GetTexture("number_" + std::to_string(grid[r][c].adjacentMines) + ".png"));
-                        window.draw(overlaySprite);
-                    }
-                }
-            }
-        }
+    TRACE_SCOPE("Board::Draw");
+    window.setView(view);
+
+    if (paused) {
+        // Every cell looks the same while paused, so one repeated-texture quad covers the board.
+        sf::Texture& revealed = textures.GetTexture(TextureManager::TILE_REVEALED);
+        revealed.setRepeated(true);
+        pausedCover.setTexture(&revealed);
+        window.draw(pausedCover);
+        METRIC_DRAW(4);
+    } else {
+        float pixelScale = view.getSize().x / viewportSize.x;
+        chunkCache.Draw(window, view, pixelScale, [this, &textures](sf::RenderTarget& target, int firstCol, int firstRow, int lastCol, int lastRow) {
+            DrawCells(target, firstCol, firstRow, lastCol, lastRow, textures);
+        });
     }
+
+    window.setView(window.getDefaultView());
 }
 
-void Board::LeftClickTile(float x, float y) {
-    if (currentState != PLAYING) return;
-    int c, r;
-    if (GetTileIndices(x, y, c, r)) {
-        Tile* tile = GetTile(c, r);
-        if (tile->isRevealed || tile->hasFlag) return;
-
-        tile->isRevealed = true;
-        tilesRevealed++;
-
-        if (tile->isMine) {
-            currentState = LOSE;
-            for (int i = 0; i < rows; ++i) {
-                for (int j = 0; j < columns; ++j) {
-                     if(grid[i][j].isMine) {
-                         grid[i][j].isRevealed = true;
-                     }
+void Board::DrawCells(sf::RenderTarget& target, int firstCol, int firstRow, int lastCol, int lastRow, TextureManager& textures) {
+    sf::Sprite baseSprite(textures.GetTexture(TextureManager::TILE_HIDDEN));
+    sf::Sprite overlaySprite(textures.GetTexture(TextureManager::TILE_HIDDEN));
+    for (int r = firstRow; r < lastRow; ++r) {
+        for (int c = firstCol; c < lastCol; ++c) {
+            int cell = r * columns + c;
+            sf::Vector2f position(c * 32.0f, r * 32.0f);
+            bool revealed = field.IsRevealed(cell);
+            baseSprite.setTexture(textures.GetTexture(revealed ? TextureManager::TILE_REVEALED : TextureManager::TILE_HIDDEN));
+            baseSprite.setPosition(position);
+            target.draw(baseSprite);
+            METRIC_DRAW(4);
+
+            overlaySprite.setPosition(position);
+            if (!revealed) {
+                if (field.HasFlag(cell)) {
+                    overlaySprite.setTexture(textures.GetTexture(TextureManager::FLAG));
+                    target.draw(overlaySprite);
+                    METRIC_DRAW(4);
+                }
+                else if (debugMode && field.IsMine(cell)) {
+                    overlaySprite.setTexture(textures.GetTexture(TextureManager::MINE));
+                    target.draw(overlaySprite);
+                    METRIC_DRAW(4);
                 }
             }
-        } else {
-            if (tile->adjacentMines == 0) RevealEmptyTiles(tile);
-            if (tilesRevealed == totalTiles - totalMines) {
-                currentState = WIN;
-                for (int i = 0; i < rows; ++i) {
-                     for (int j = 0; j < columns; ++j) {
-                         if(grid[i][j].isMine) grid[i][j].hasFlag = true;
-                     }
+            else {
+                if (field.IsMine(cell)) {
+                    overlaySprite.setTexture(textures.GetTexture(TextureManager::MINE));
+                    target.draw(overlaySprite);
+                    METRIC_DRAW(4);
+                }
+                else if (field.GetAdjacentMines(cell) > 0) {
+                    overlaySprite.setTexture(textures.GetTexture(TextureManager::NumberTexture(field.GetAdjacentMines(cell))));
+                    target.draw(overlaySprite);
+                    METRIC_DRAW(4);
                 }
-                flagsPlaced = totalMines;
             }
         }
     }
 }
 
-void Board::RightClickTile(float x, float y) {
-    if (currentState != PLAYING) return;
-    int c, r;
-    if (GetTileIndices(x, y, c, r)) {
-        Tile* tile = GetTile(c, r);
-        if (!tile->isRevealed) {
-            tile->hasFlag = !tile->hasFlag;
-            flagsPlaced += (tile->hasFlag ? 1 : -1);
-        }
-    }
+void Board::RevealCell(int cell) {
+    TRACE_SCOPE("Board::RevealCell");
+    [[maybe_unused]] int revealed = field.RevealCell(cell);
+    METRIC_ADD(CLICKS, 1);
+    METRIC_ADD(TILES_REVEALED, revealed);
+    METRIC_MAX(FLOOD_FILL_PEAK_FRONTIER, field.GetLastPeakFrontier());
+    SyncAfterAction();
 }
 
-void Board::RevealEmptyTiles(Tile* tile) {
-    for (Tile* neighbor : tile->adjacentTiles) {
-        if (!neighbor->isRevealed && !neighbor->hasFlag && !neighbor->isMine) {
-            neighbor->isRevealed = true;
-            tilesRevealed++;
-            if (neighbor->adjacentMines == 0) RevealEmptyTiles(neighbor);
-        }
+void Board::ToggleFlag(int cell) {
+    field.ToggleFlag(cell);
+    SyncAfterAction();
+}
+
+// Mirrors the field's state into the public members and redraws only the cells that changed.
+void Board::SyncAfterAction() {
+    GameState previousState = currentState;
+    currentState = static_cast<GameState>(field.GetState());
+    flagsPlaced = field.GetFlagsPlaced();
+
+    if (currentState != previousState) {
+        chunkCache.InvalidateAll();
+        return;
+    }
+    for (int cell : field.GetChangedCells()) {
+        chunkCache.Invalidate(cell % columns, cell / columns);
     }
 }
 
 void Board::ToggleDebugMode() {
-    if (currentState == PLAYING) debugMode = !debugMode;
+    if (currentState == PLAYING) {
+        debugMode = !debugMode;
+        chunkCache.InvalidateAll();
+    }
 }
-
-Tile* Board::GetTile(int col, int row) {
-    return &grid[row][col];
-}
\ No newline at end of file
@@ -5,7 +5,8 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include "Tile.h"
+#include "BoardChunkCache.h"
+#include "MineField.h"
 #include <vector>
 #include <SFML/Graphics.hpp>
 
@@ -14,21 +15,28 @@ class TextureManager;
 class Board {
 public:
     Board();
-    void Initialize(int cols, int rows, int mines, TextureManager& textures);
-    void Restart(TextureManager& textures);
+    // A nonzero seed fixes the mine layout (daily challenges); zero picks a fresh one each game.
+    void Initialize(int cols, int rows, int mines, unsigned long long seed = 0);
+    void Restart();
     void Draw(sf::RenderWindow& window, bool paused, TextureManager& textures);
-    void SetupNeighbors();
-    void PlaceMines(int mineCount);
-    void CalculateAdjacentMines();
 
-    void LeftClickTile(float x, float y);
-    void RightClickTile(float x, float y);
-    void RevealEmptyTiles(Tile* tile);
+    // Maps a window pixel to a cell index, or -1 if it's off the board.
+    int GetCellAt(float x, float y) const;
+    void RevealCell(int cell);
+    void ToggleFlag(int cell);
 
     void ToggleDebugMode();
 
-    Tile* GetTile(int col, int row);
-    int GetTotalMines() const { return totalMines; }
+    void SetViewport(float width, float height, float windowHeight);
+    void ResetView();
+    void Zoom(float factor, float x, float y);
+    void Pan(float dx, float dy);
+    const sf::View& GetView() const { return view; }
+
+    const MineField& GetField() const { return field; }
+    int GetTotalMines() const { return field.GetTotalMines(); }
+    unsigned long long GetSeed() const { return field.GetSeed(); }
+    int Calculate3BV() const { return field.Calculate3BV(); }
 
     enum GameState { PLAYING, WIN, LOSE };
     GameState currentState = PLAYING;
@@ -36,17 +44,23 @@ public:
     bool leaderboardShown = false;
 
 private:
+    MineField field;
     int columns = 0;
     int rows = 0;
-    int totalMines = 0;
-    int tilesRevealed = 0;
-    int totalTiles = 0;
     bool debugMode = false;
+    unsigned long long fixedSeed = 0;
+
+    sf::View view;
+    sf::Vector2f viewportSize;
+    float windowHeight = 0.0f;
+    BoardChunkCache chunkCache;
+    sf::RectangleShape pausedCover;
 
-    std::vector<std::vector<Tile>> grid;
+    void DrawCells(sf::RenderTarget& target, int firstCol, int firstRow, int lastCol, int lastRow, TextureManager& textures);
+    void SyncAfterAction();
 
-    bool GetTileIndices(float x, float y, int& col, int& row);
-    std::vector<Tile*> GetNeighbors(int col, int row);
+    void ClampView();
+    sf::Vector2f PixelToWorld(float x, float y) const;
 };
 
-#endif
\ No newline at end of file
+#endif
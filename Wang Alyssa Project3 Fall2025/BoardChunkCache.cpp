@@ -0,0 +1,123 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "BoardChunkCache.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+
+static const int CHUNK_PIXELS = BoardChunkCache::CHUNK_CELLS * 32;
+static const int MAX_LOD = 5;
+
+size_t BoardChunkCache::ChunkBytes(int lod) {
+    size_t side = CHUNK_PIXELS >> lod;
+    return side * side * 4;
+}
+
+void BoardChunkCache::Reset(int columns, int rows) {
+    if (columns != this->columns || rows != this->rows) {
+        chunks.clear();
+        lru.clear();
+        memoryUsed = 0;
+    }
+    this->columns = columns;
+    this->rows = rows;
+    chunkColumns = (columns + CHUNK_CELLS - 1) / CHUNK_CELLS;
+    chunkRows = (rows + CHUNK_CELLS - 1) / CHUNK_CELLS;
+    InvalidateAll();
+}
+
+void BoardChunkCache::Invalidate(int col, int row) {
+    auto it = chunks.find((row / CHUNK_CELLS) * chunkColumns + col / CHUNK_CELLS);
+    if (it != chunks.end()) it->second.dirty = true;
+}
+
+void BoardChunkCache::InvalidateAll() {
+    for (auto& entry : chunks) {
+        entry.second.dirty = true;
+    }
+}
+
+bool BoardChunkCache::RenderChunk(int index, Chunk& chunk, int lod, const DrawCellsFunction& drawCells) {
+    if (!chunk.texture || chunk.lod != lod) {
+        if (!chunk.texture) chunk.texture = std::make_unique<sf::RenderTexture>();
+        else memoryUsed -= ChunkBytes(chunk.lod);
+
+        unsigned int side = CHUNK_PIXELS >> lod;
+        if (!chunk.texture->resize({side, side})) {
+            chunk.texture.reset();
+            return false;
+        }
+        chunk.lod = lod;
+        chunk.texture->setSmooth(lod > 0);
+        memoryUsed += ChunkBytes(lod);
+    }
+
+    int firstCol = (index % chunkColumns) * CHUNK_CELLS;
+    int firstRow = (index / chunkColumns) * CHUNK_CELLS;
+    sf::Vector2f origin(firstCol * 32.0f, firstRow * 32.0f);
+    chunk.texture->setView(sf::View(sf::FloatRect(origin, {(float)CHUNK_PIXELS, (float)CHUNK_PIXELS})));
+    chunk.texture->clear(sf::Color::Transparent);
+    drawCells(*chunk.texture, firstCol, firstRow, std::min(columns, firstCol + CHUNK_CELLS), std::min(rows, firstRow + CHUNK_CELLS));
+    chunk.texture->display();
+    chunk.dirty = false;
+    return true;
+}
+
+void BoardChunkCache::Draw(sf::RenderTarget& target, const sf::View& view, float pixelScale, const DrawCellsFunction& drawCells) {
+    ++frame;
+
+    int lod = 0;
+    while (lod < MAX_LOD && pixelScale >= (float)(2 << lod)) ++lod;
+
+    sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.0f;
+    sf::Vector2f bottomRight = view.getCenter() + view.getSize() / 2.0f;
+    int firstChunkCol = std::max(0, static_cast<int>(topLeft.x / CHUNK_PIXELS));
+    int firstChunkRow = std::max(0, static_cast<int>(topLeft.y / CHUNK_PIXELS));
+    int lastChunkCol = std::min(chunkColumns, static_cast<int>(std::ceil(bottomRight.x / CHUNK_PIXELS)));
+    int lastChunkRow = std::min(chunkRows, static_cast<int>(std::ceil(bottomRight.y / CHUNK_PIXELS)));
+
+    for (int cr = firstChunkRow; cr < lastChunkRow; ++cr) {
+        for (int cc = firstChunkCol; cc < lastChunkCol; ++cc) {
+            int index = cr * chunkColumns + cc;
+            auto it = chunks.find(index);
+            if (it == chunks.end()) {
+                it = chunks.emplace(index, Chunk()).first;
+                lru.push_front(index);
+                it->second.lruPosition = lru.begin();
+            } else {
+                lru.splice(lru.begin(), lru, it->second.lruPosition);
+            }
+
+            Chunk& chunk = it->second;
+            chunk.lastFrame = frame;
+            if (chunk.dirty || chunk.lod != lod || !chunk.texture) {
+                if (!RenderChunk(index, chunk, lod, drawCells)) {
+                    drawCells(target, cc * CHUNK_CELLS, cr * CHUNK_CELLS,
+                              std::min(columns, (cc + 1) * CHUNK_CELLS), std::min(rows, (cr + 1) * CHUNK_CELLS));
+                    continue;
+                }
+            }
+
+            sf::Sprite sprite(chunk.texture->getTexture());
+            sprite.setPosition({(float)(cc * CHUNK_PIXELS), (float)(cr * CHUNK_PIXELS)});
+            sprite.setScale({(float)(1 << chunk.lod), (float)(1 << chunk.lod)});
+            target.draw(sprite);
+            METRIC_DRAW(4);
+        }
+    }
+
+    EvictOverBudget();
+}
+
+void BoardChunkCache::EvictOverBudget() {
+    // Chunks drawn this frame sit at the front of the list and are never evicted.
+    while (memoryUsed > memoryBudget && !lru.empty()) {
+        auto it = chunks.find(lru.back());
+        if (it->second.lastFrame == frame) break;
+        if (it->second.texture) memoryUsed -= ChunkBytes(it->second.lod);
+        chunks.erase(it);
+        lru.pop_back();
+    }
+}
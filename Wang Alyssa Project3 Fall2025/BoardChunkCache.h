@@ -0,0 +1,55 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_BOARDCHUNKCACHE_H
+#define MINESWEEPER_BOARDCHUNKCACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Caches pre-rendered CHUNK_CELLS x CHUNK_CELLS regions of the board in render textures.
+// Chunks are rendered at a lower resolution when zoomed out, and the least recently drawn
+// chunks are evicted once the cache grows past its memory budget.
+class BoardChunkCache {
+public:
+    static const int CHUNK_CELLS = 64;
+    using DrawCellsFunction = std::function<void(sf::RenderTarget&, int firstCol, int firstRow, int lastCol, int lastRow)>;
+
+    void Reset(int columns, int rows);
+    void Invalidate(int col, int row);
+    void InvalidateAll();
+    void Draw(sf::RenderTarget& target, const sf::View& view, float pixelScale, const DrawCellsFunction& drawCells);
+
+    void SetMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+
+private:
+    struct Chunk {
+        std::unique_ptr<sf::RenderTexture> texture;
+        int lod = 0;
+        bool dirty = true;
+        unsigned long long lastFrame = 0;
+        std::list<int>::iterator lruPosition;
+    };
+
+    int columns = 0;
+    int rows = 0;
+    int chunkColumns = 0;
+    int chunkRows = 0;
+    unsigned long long frame = 0;
+    size_t memoryUsed = 0;
+    size_t memoryBudget = 256 * 1024 * 1024;
+
+    std::unordered_map<int, Chunk> chunks;
+    std::list<int> lru;
+
+    bool RenderChunk(int index, Chunk& chunk, int lod, const DrawCellsFunction& drawCells);
+    void EvictOverBudget();
+    static size_t ChunkBytes(int lod);
+};
+
+#endif
@@ -0,0 +1,109 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "CompletionHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+static const char HISTOGRAM_MAGIC[4] = {'M', 'S', 'H', 'G'};
+
+struct HistogramHeader {
+    char magic[4];
+    uint32_t bucketCount;
+    uint64_t totalCount;
+};
+
+void CompletionHistogram::Clear() {
+    std::fill(counts, counts + BUCKET_COUNT, 0);
+    totalCount = 0;
+}
+
+// Values below SUB_BUCKETS map to themselves. Above that, the top SUB_BUCKET_BITS + 1 bits
+// pick the bucket: every doubling adds SUB_BUCKETS buckets, each twice as wide as before.
+int CompletionHistogram::BucketIndex(uint32_t value) {
+    value = std::min<uint32_t>(value, (1u << MAX_VALUE_BITS) - 1);
+    if (value < (uint32_t)SUB_BUCKETS) return (int)value;
+    int highestBit = 31 - __builtin_clz(value);
+    int shift = highestBit - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + (int)(value >> shift);
+}
+
+uint32_t CompletionHistogram::BucketHighest(int index) {
+    if (index < SUB_BUCKETS) return (uint32_t)index;
+    int shift = index / SUB_BUCKETS - 1;
+    uint32_t subBucket = (uint32_t)(index - shift * SUB_BUCKETS);
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void CompletionHistogram::Add(uint32_t value, uint64_t count) {
+    counts[BucketIndex(value)] += count;
+    totalCount += count;
+}
+
+void CompletionHistogram::Merge(const CompletionHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) counts[i] += other.counts[i];
+    totalCount += other.totalCount;
+}
+
+uint32_t CompletionHistogram::GetPercentile(double percentile) const {
+    if (totalCount == 0) return 0;
+    double clamped = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(clamped / 100.0 * (double)totalCount));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= target) return BucketHighest(i);
+    }
+    return BucketHighest(BUCKET_COUNT - 1);
+}
+
+bool CompletionHistogram::Load(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    HistogramHeader header;
+    CompletionHistogram loaded;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, HISTOGRAM_MAGIC, sizeof(HISTOGRAM_MAGIC)) == 0 &&
+                 header.bucketCount == (uint32_t)BUCKET_COUNT &&
+                 std::fread(loaded.counts, sizeof(uint64_t), BUCKET_COUNT, file) == (size_t)BUCKET_COUNT;
+    std::fclose(file);
+    if (!valid) {
+        std::cerr << "Error: " << path << " is not a completion histogram!" << std::endl;
+        return false;
+    }
+
+    loaded.totalCount = header.totalCount;
+    *this = loaded;
+    return true;
+}
+
+bool CompletionHistogram::Save(const std::string& path) const {
+    std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Could not write " << tempPath << "!" << std::endl;
+        return false;
+    }
+
+    HistogramHeader header;
+    std::memcpy(header.magic, HISTOGRAM_MAGIC, sizeof(HISTOGRAM_MAGIC));
+    header.bucketCount = BUCKET_COUNT;
+    header.totalCount = totalCount;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(counts, sizeof(uint64_t), BUCKET_COUNT, file) == (size_t)BUCKET_COUNT &&
+                   std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    std::fclose(file);
+
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not replace " << path << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_COMPLETIONHISTOGRAM_H
+#define MINESWEEPER_COMPLETIONHISTOGRAM_H
+
+#include <cstdint>
+#include <string>
+
+// Fixed-size, log-bucketed histogram of completion times in the style of HdrHistogram.
+// Each power of two is split into SUB_BUCKETS linear buckets, so values below 64 are exact
+// and larger ones are kept to within about 3%. Histograms from different processes or
+// machines combine with Merge(), and percentile queries walk the buckets once.
+class CompletionHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values up to 8191 seconds, which covers the 99:59 clock.
+    static const int MAX_VALUE_BITS = 13;
+    static const int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void Clear();
+    void Add(uint32_t value, uint64_t count = 1);
+    void Merge(const CompletionHistogram& other);
+    uint64_t GetTotalCount() const { return totalCount; }
+    // The highest value in the bucket holding the given percentile (0-100), or 0 if empty.
+    uint32_t GetPercentile(double percentile) const;
+
+    // Load() returns false if the file is missing or not a histogram; Save() replaces the
+    // file atomically.
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+private:
+    uint64_t counts[BUCKET_COUNT] = {};
+    uint64_t totalCount = 0;
+
+    static int BucketIndex(uint32_t value);
+    static uint32_t BucketHighest(int index);
+};
+
+#endif //MINESWEEPER_COMPLETIONHISTOGRAM_H
@@ -0,0 +1,144 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+static const char* const PHASE_NAMES[FrameProfiler::PHASE_COUNT + 1] = {
+    "events", "update", "board", "hud", "leaderboard", "overlay", "display", "frame"
+};
+static const float BAR_LEFT = 100.0f;
+static const float BAR_MAX_WIDTH = 200.0f;
+static const float PIXELS_PER_MS = 20.0f;
+static const float ROW_HEIGHT = 20.0f;
+
+void FrameProfiler::Initialize(const sf::Font& font) {
+    labels.clear();
+    values.clear();
+    for (int row = 0; row <= PHASE_COUNT; ++row) {
+        labels.emplace_back(font, PHASE_NAMES[row], 12);
+        labels.back().setPosition({8.0f, 8.0f + row * ROW_HEIGHT});
+        values.emplace_back(font, "", 12);
+        values.back().setPosition({BAR_LEFT + BAR_MAX_WIDTH + 10.0f, 8.0f + row * ROW_HEIGHT});
+    }
+    scratch.reserve(HISTORY);
+}
+
+void FrameProfiler::BeginFrame() {
+    current.fill(0);
+    lastMark = std::chrono::steady_clock::now();
+}
+
+void FrameProfiler::Mark(Phase phase) {
+    auto now = std::chrono::steady_clock::now();
+    current[phase] += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(now - lastMark).count();
+    lastMark = now;
+}
+
+void FrameProfiler::EndFrame() {
+    uint64_t frame = framesWritten.load(std::memory_order_relaxed);
+    Sample& sample = samples[frame % HISTORY];
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        sample.micros[phase].store(current[phase], std::memory_order_relaxed);
+    }
+    framesWritten.store(frame + 1, std::memory_order_release);
+}
+
+size_t FrameProfiler::Snapshot(std::vector<std::array<uint32_t, PHASE_COUNT>>& out) const {
+    uint64_t end = framesWritten.load(std::memory_order_acquire);
+    uint64_t begin = end > (uint64_t)HISTORY ? end - HISTORY : 0;
+    out.resize(end - begin);
+    for (uint64_t frame = begin; frame < end; ++frame) {
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            out[frame - begin][phase] = samples[frame % HISTORY].micros[phase].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Anything the writer overwrote while we were copying is no longer trustworthy.
+    uint64_t after = framesWritten.load(std::memory_order_acquire);
+    uint64_t firstValid = after > (uint64_t)HISTORY ? after - HISTORY : 0;
+    if (firstValid > begin) {
+        size_t lapped = (size_t)std::min<uint64_t>(firstValid - begin, out.size());
+        out.erase(out.begin(), out.begin() + lapped);
+    }
+    return out.size();
+}
+
+void FrameProfiler::UpdateOverlay() {
+    if (!overlayVisible || labels.empty()) return;
+
+    uint64_t end = framesWritten.load(std::memory_order_acquire);
+    size_t count = (size_t)std::min<uint64_t>(end, HISTORY);
+    bars.clear();
+
+    for (int row = 0; row <= PHASE_COUNT; ++row) {
+        scratch.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const Sample& sample = samples[(end - 1 - i) % HISTORY];
+            uint32_t micros = 0;
+            if (row == PHASE_COUNT) {
+                for (int phase = 0; phase < PHASE_COUNT; ++phase) micros += sample.micros[phase].load(std::memory_order_relaxed);
+            } else {
+                micros = sample.micros[row].load(std::memory_order_relaxed);
+            }
+            scratch.push_back(micros);
+        }
+        if (scratch.empty()) continue;
+
+        uint64_t total = 0;
+        for (uint32_t micros : scratch) total += micros;
+        float minMs = *std::min_element(scratch.begin(), scratch.end()) / 1000.0f;
+        float avgMs = (float)total / scratch.size() / 1000.0f;
+        std::nth_element(scratch.begin(), scratch.begin() + (scratch.size() * 99) / 100, scratch.end());
+        float p99Ms = scratch[(scratch.size() * 99) / 100] / 1000.0f;
+
+        const float stats[3] = {minMs, avgMs, p99Ms};
+        const sf::Color colors[3] = {sf::Color::Green, sf::Color::Yellow, sf::Color::Red};
+        for (int bar = 0; bar < 3; ++bar) {
+            float x = BAR_LEFT;
+            float y = 10.0f + row * ROW_HEIGHT + bar * 5.0f;
+            float w = std::min(BAR_MAX_WIDTH, std::max(1.0f, stats[bar] * PIXELS_PER_MS));
+            sf::Vector2f corners[6] = {{x, y}, {x + w, y}, {x + w, y + 4.0f}, {x, y}, {x + w, y + 4.0f}, {x, y + 4.0f}};
+            for (const sf::Vector2f& corner : corners) bars.append(sf::Vertex{corner, colors[bar]});
+        }
+
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.2f / %.2f / %.2f ms", minMs, avgMs, p99Ms);
+        values[row].setString(text);
+    }
+}
+
+bool FrameProfiler::DumpCsv(const std::string& path) const {
+    std::vector<std::array<uint32_t, PHASE_COUNT>> frames;
+    Snapshot(frames);
+
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        file << PHASE_NAMES[phase] << "_us,";
+    }
+    file << "frame_us\n";
+    for (const auto& frame : frames) {
+        uint32_t total = 0;
+        for (uint32_t micros : frame) {
+            file << micros << ",";
+            total += micros;
+        }
+        file << total << "\n";
+    }
+    return file.good();
+}
+
+void FrameProfiler::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!overlayVisible) return;
+
+    sf::RectangleShape background({BAR_LEFT + BAR_MAX_WIDTH + 150.0f, (PHASE_COUNT + 1) * ROW_HEIGHT + 12.0f});
+    background.setFillColor(sf::Color(0, 0, 0, 180));
+    target.draw(background, states);
+    target.draw(bars, states);
+    for (const sf::Text& label : labels) target.draw(label, states);
+    for (const sf::Text& value : values) target.draw(value, states);
+}
@@ -0,0 +1,53 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_FRAMEPROFILER_H
+#define MINESWEEPER_FRAMEPROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-phase frame timings kept in a lock-free ring buffer. The main loop is the only writer;
+// readers (the overlay and CSV dumps) copy a snapshot and drop any slot the writer lapped.
+class FrameProfiler : public sf::Drawable {
+public:
+    enum Phase { EVENTS, UPDATE, BOARD_DRAW, HUD, LEADERBOARD_WINDOW, OVERLAY, DISPLAY, PHASE_COUNT };
+    static const int HISTORY = 1024;
+
+    void Initialize(const sf::Font& font);
+    void BeginFrame();
+    void Mark(Phase phase);
+    void EndFrame();
+
+    void ToggleOverlay() { overlayVisible = !overlayVisible; }
+    bool IsOverlayVisible() const { return overlayVisible; }
+    void UpdateOverlay();
+    bool DumpCsv(const std::string& path) const;
+
+private:
+    struct Sample {
+        std::array<std::atomic<uint32_t>, PHASE_COUNT> micros;
+    };
+
+    std::array<Sample, HISTORY> samples{};
+    std::atomic<uint64_t> framesWritten{0};
+    std::array<uint32_t, PHASE_COUNT> current{};
+    std::chrono::steady_clock::time_point lastMark;
+
+    bool overlayVisible = false;
+    std::vector<sf::Text> labels;
+    std::vector<sf::Text> values;
+    sf::VertexArray bars{sf::PrimitiveType::Triangles};
+    std::vector<uint32_t> scratch;
+
+    size_t Snapshot(std::vector<std::array<uint32_t, PHASE_COUNT>>& out) const;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
+
+#endif
@@ -0,0 +1,99 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "GameServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// How long the accept/aggregate loop sleeps between passes over the shard queues.
+static const int AGGREGATE_INTERVAL_MILLIS = 50;
+
+GameServer::~GameServer() {
+    shards.clear();
+    if (listenFd >= 0) close(listenFd);
+    if (wakeFd >= 0) close(wakeFd);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+}
+
+bool GameServer::Listen(const std::string& address, unsigned int shardCount) {
+    listenFd = ListenOn(address);
+    if (listenFd < 0) return false;
+    if (address.rfind("unix:", 0) == 0) unixPath = address.substr(5);
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        std::cerr << "Error: Could not create an eventfd: " << std::strerror(errno) << "!" << std::endl;
+        return false;
+    }
+    shardCount = std::max(1u, shardCount);
+    std::vector<ServerShard*> peers;
+    for (unsigned int i = 0; i < shardCount; ++i) {
+        results.push_back(std::make_unique<MpscQueue<GameResult>>());
+        shards.push_back(std::make_unique<ServerShard>(i, shardCount, *results.back()));
+        peers.push_back(shards.back().get());
+    }
+    for (auto& shard : shards) shard->SetPeers(peers);
+    return true;
+}
+
+void GameServer::Stop() {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wakeFd, &one, sizeof(one));
+}
+
+void GameServer::Run() {
+    for (auto& shard : shards) {
+        if (!shard->Start(wakeFd)) {
+            Stop();
+            break;
+        }
+    }
+
+    pollfd watched[2] = {{wakeFd, POLLIN, 0}, {listenFd, POLLIN, 0}};
+    while (true) {
+        poll(watched, 2, AGGREGATE_INTERVAL_MILLIS);
+        if (watched[1].revents & POLLIN) AcceptConnections();
+        DrainResults();
+        if (watched[0].revents & POLLIN) break;
+    }
+
+    for (auto& shard : shards) {
+        shard->Join();
+        movesHandled += shard->GetMovesHandled();
+        movesPerShard.push_back(shard->GetMovesHandled());
+        gamesStarted += shard->GetGamesStarted();
+    }
+    DrainResults();
+}
+
+void GameServer::AcceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "Error: accept failed: " << std::strerror(errno) << "!" << std::endl;
+            }
+            return;
+        }
+        shards[nextShard]->Post({ShardMessage::ADOPT, fd, 0, 0, 0, nullptr});
+        nextShard = (nextShard + 1) % shards.size();
+    }
+}
+
+void GameServer::DrainResults() {
+    GameResult result;
+    for (auto& queue : results) {
+        while (queue->Pop(result)) {
+            if (result.won) gamesWon++;
+            else gamesLost++;
+            movesPerGame.Add(result.moves);
+        }
+    }
+}
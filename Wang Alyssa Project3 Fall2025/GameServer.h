@@ -0,0 +1,59 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_GAMESERVER_H
+#define MINESWEEPER_GAMESERVER_H
+
+#include "CompletionHistogram.h"
+#include "MpscQueue.h"
+#include "ServerShard.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hosts headless games for bots and thin clients. New connections are dealt out to the
+// ServerShard threads in turn; a connection may run many sessions at once and pipeline
+// requests for all of them, and replies come back in request order. Sessions belong to the
+// connection that started them and end with it, but each runs on the shard its id picks, and
+// a connection's new sessions are dealt round the shards, so load is spread by session.
+//
+// The thread that called Run() accepts connections and aggregates: finished games flow from
+// each shard to it through that shard's own lock-free queue.
+class GameServer {
+public:
+    ~GameServer();
+    bool Listen(const std::string& address, unsigned int shardCount);
+    void Run();
+    // Makes Run() return. Only writes to an eventfd, so it's safe from a signal handler.
+    void Stop();
+
+    // Totals over all shards, valid once Run() has returned.
+    unsigned long long GetMovesHandled() const { return movesHandled; }
+    unsigned long long GetGamesStarted() const { return gamesStarted; }
+    unsigned long long GetGamesWon() const { return gamesWon; }
+    unsigned long long GetGamesLost() const { return gamesLost; }
+    const CompletionHistogram& GetMovesPerGame() const { return movesPerGame; }
+    // Moves each shard applied, which shows how evenly sessions were spread.
+    const std::vector<unsigned long long>& GetMovesPerShard() const { return movesPerShard; }
+
+private:
+    int listenFd = -1;
+    int wakeFd = -1;
+    std::string unixPath;
+    std::vector<std::unique_ptr<MpscQueue<GameResult>>> results;
+    std::vector<std::unique_ptr<ServerShard>> shards;
+    size_t nextShard = 0;
+
+    unsigned long long movesHandled = 0;
+    unsigned long long gamesStarted = 0;
+    unsigned long long gamesWon = 0;
+    unsigned long long gamesLost = 0;
+    CompletionHistogram movesPerGame;
+    std::vector<unsigned long long> movesPerShard;
+
+    void AcceptConnections();
+    void DrainResults();
+};
+
+#endif //MINESWEEPER_GAMESERVER_H
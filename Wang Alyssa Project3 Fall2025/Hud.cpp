@@ -0,0 +1,66 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "Hud.h"
+#include <cstdlib>
+
+// Slots 0-3: mine counter (optional minus sign + 3 digits), 4-5: minutes, 6-7: seconds.
+void Hud::Initialize(const sf::Texture& digits, float width, float yPos) {
+    digitsTexture = &digits;
+    this->width = width;
+    this->yPos = yPos;
+
+    mineCounter = -1;
+    SetMineCounter(0);
+    time = -1;
+    SetTime(0);
+}
+
+void Hud::SetGlyph(int slot, int glyph, float x) {
+    sf::Vertex* quad = &vertices[slot * 6];
+    float w = (glyph == HIDDEN_GLYPH) ? 0.0f : 21.0f;
+    float u = (float)(glyph * 21);
+
+    sf::Vector2f positions[4] = {{x, yPos}, {x + w, yPos}, {x + w, yPos + 32.0f}, {x, yPos + 32.0f}};
+    sf::Vector2f texCoords[4] = {{u, 0.0f}, {u + 21.0f, 0.0f}, {u + 21.0f, 32.0f}, {u, 32.0f}};
+    const int corners[6] = {0, 1, 2, 0, 2, 3};
+    for (int i = 0; i < 6; ++i) {
+        quad[i].position = positions[corners[i]];
+        quad[i].texCoords = texCoords[corners[i]];
+    }
+}
+
+void Hud::SetMineCounter(int value) {
+    if (value == mineCounter) return;
+    mineCounter = value;
+
+    int digits = std::abs(value) % 1000;
+    float x = 33.0f;
+    if (value < 0) {
+        SetGlyph(0, MINUS_GLYPH, x);
+        x += 21.0f;
+    } else {
+        SetGlyph(0, HIDDEN_GLYPH, x);
+    }
+    SetGlyph(1, digits / 100, x);
+    SetGlyph(2, digits / 10 % 10, x + 21.0f);
+    SetGlyph(3, digits % 10, x + 42.0f);
+}
+
+void Hud::SetTime(long long totalSeconds) {
+    if (totalSeconds == time) return;
+    time = totalSeconds;
+
+    int minutes = (int)(totalSeconds / 60 % 100);
+    int seconds = (int)(totalSeconds % 60);
+    SetGlyph(4, minutes / 10, width - 97.0f);
+    SetGlyph(5, minutes % 10, width - 76.0f);
+    SetGlyph(6, seconds / 10, width - 54.0f);
+    SetGlyph(7, seconds % 10, width - 33.0f);
+}
+
+void Hud::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    states.texture = digitsTexture;
+    target.draw(vertices, states);
+}
@@ -0,0 +1,34 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_HUD_H
+#define MINESWEEPER_HUD_H
+
+#include <SFML/Graphics.hpp>
+
+// Mine counter and timer drawn from digits.png in a single batched draw.
+// Quads are prebuilt once; texture coordinates are only rewritten when a value changes.
+class Hud : public sf::Drawable {
+public:
+    void Initialize(const sf::Texture& digits, float width, float yPos);
+    void SetMineCounter(int value);
+    void SetTime(long long totalSeconds);
+
+private:
+    static const int GLYPH_COUNT = 8;
+    static const int MINUS_GLYPH = 10;
+    static const int HIDDEN_GLYPH = -1;
+
+    sf::VertexArray vertices{sf::PrimitiveType::Triangles, GLYPH_COUNT * 6};
+    const sf::Texture* digitsTexture = nullptr;
+    float width = 0.0f;
+    float yPos = 0.0f;
+    int mineCounter = 0;
+    long long time = 0;
+
+    void SetGlyph(int slot, int glyph, float x);
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
+
+#endif
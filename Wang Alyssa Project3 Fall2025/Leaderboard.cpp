@@ -4,17 +4,39 @@
 
 #include <algorithm>
 #include "Leaderboard.h"
+#include "Trace.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-int Leaderboard::TimeToSeconds(const std::string& timeStr) {
-    if (timeStr.length() < 5) return 9999;
-    try {
-        int minutes = std::stoi(timeStr.substr(0, 2));
-        int seconds = std::stoi(timeStr.substr(3, 2));
-        return minutes * 60 + seconds;
-    } catch (...) {
-        return 9999;
-    }
+// Accepts "MM:SS" with seconds below 60. Anything else is a malformed line, not a slow time.
+bool Leaderboard::ParseTime(std::string_view text, int& totalSeconds) {
+    size_t colon = text.find(':');
+    if (colon == 0 || colon == std::string_view::npos || text.size() - colon != 3) return false;
+    // from_chars accepts a leading '-', which no time has ("01:-5" would read as 55).
+    if (text[0] == '-' || text[colon + 1] == '-') return false;
+
+    int minutes = 0;
+    int seconds = 0;
+    const char* end = text.data() + text.size();
+    auto [minutesEnd, minutesError] = std::from_chars(text.data(), text.data() + colon, minutes);
+    auto [secondsEnd, secondsError] = std::from_chars(text.data() + colon + 1, end, seconds);
+    if (minutesError != std::errc() || minutesEnd != text.data() + colon) return false;
+    if (secondsError != std::errc() || secondsEnd != end || seconds >= 60) return false;
+    // Checked before multiplying: minutes * 60 can wrap to a negative time that would rank #1.
+    if (minutes > MAX_SECONDS / 60) return false;
+
+    totalSeconds = minutes * 60 + seconds;
+    return totalSeconds <= MAX_SECONDS;
 }
 
 std::string Leaderboard::SecondsToTime(int totalSeconds) {
@@ -25,70 +47,408 @@ std::string Leaderboard::SecondsToTime(int totalSeconds) {
     return mStr + ":" + sStr;
 }
 
-Leaderboard::Leaderboard() {
+static const char* const STORE_DIRECTORY = "files/leaderboards";
+static const char* const LEGACY_PATH = "files/leaderboard.txt";
+static const char* const LEGACY_JOURNAL_PATH = "files/leaderboard.journal";
+static const char* const SEQUENCE_HEADER = "#seq ";
+
+// Flushes a C stream all the way to disk before we rely on it surviving a crash.
+static bool SyncFile(std::FILE* file) {
+    return std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+}
+
+// Advisory flock() on a sidecar file, held for the lifetime of the object. The snapshot
+// can't carry the lock itself because compaction renames a new file over it.
+class LeaderboardLock {
+public:
+    LeaderboardLock(const std::string& path, bool exclusive) {
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Error: Could not open " << path << "!" << std::endl;
+            return;
+        }
+        while (flock(fd, exclusive ? LOCK_EX : LOCK_SH) != 0 && errno == EINTR) {}
+    }
+    ~LeaderboardLock() {
+        if (fd >= 0) close(fd);
+    }
+    LeaderboardLock(const LeaderboardLock&) = delete;
+    LeaderboardLock& operator=(const LeaderboardLock&) = delete;
+
+private:
+    int fd = -1;
+};
+
+// Read-only mapping of a whole file. A missing or empty file maps to an empty view.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapping);
+                size = (size_t)info.st_size;
+            } else {
+                std::cerr << "Error: Could not map " << path << "!" << std::endl;
+            }
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view View() const { return std::string_view(data ? data : "", size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// Calls onLine(line, lineNumber) for every line, minus any '\r'. A last line without a
+// newline is only passed on when includeUnterminated is set.
+template <typename LineFunction>
+static void ForEachLine(std::string_view text, bool includeUnterminated, LineFunction onLine) {
+    size_t lineNumber = 0;
+    while (!text.empty()) {
+        const void* newline = std::memchr(text.data(), '\n', text.size());
+        if (!newline && !includeUnterminated) break;
+        size_t length = newline ? static_cast<const char*>(newline) - text.data() : text.size();
+        std::string_view line = text.substr(0, length);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        onLine(line, ++lineNumber);
+        text.remove_prefix(newline ? length + 1 : length);
+    }
+}
+
+static bool ParseSequence(std::string_view text, unsigned long long& sequence) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), sequence);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+static const int MAX_REPORTED_LINES = 5;
+
+static void ReportMalformed(const std::string& path, size_t lineNumber, std::string_view line, int& malformed) {
+    if (++malformed <= MAX_REPORTED_LINES) {
+        std::cerr << "Error: Malformed line " << lineNumber << " in " << path << ": \"" << line << "\"!" << std::endl;
+    }
+}
+
+// The store is a directory with one snapshot + journal pair per key, named after the key.
+// Opening a key is a single directory lookup and never reads another key's files.
+std::string Leaderboard::StorePath(const LeaderboardKey& key) {
+    std::string path = std::string(STORE_DIRECTORY) + "/c" + std::to_string(key.columns) +
+                       "_r" + std::to_string(key.rows) + "_m" + std::to_string(key.mines);
+    if (key.seed != 0) path += "_s" + std::to_string(key.seed);
+    return path;
+}
+
+Leaderboard::Leaderboard(const LeaderboardKey& key, int maxEntries)
+    : key(key), maxEntries(std::max(1, maxEntries))
+{
+    std::string base = StorePath(key);
+    snapshotPath = base + ".txt";
+    journalPath = base + ".journal";
+    lockPath = base + ".lock";
+    histogramPath = base + ".hist";
+
+    std::error_code error;
+    std::filesystem::create_directories(STORE_DIRECTORY, error);
+    {
+        LeaderboardLock lock(lockPath, true);
+        MigrateLegacyLeaderboard();
+    }
     LoadLeaderboard();
 }
 
+// Before per-configuration boards there was a single files/leaderboard.txt. The first
+// seedless board opened without a store file of its own adopts it.
+void Leaderboard::MigrateLegacyLeaderboard() {
+    std::error_code error;
+    if (key.seed != 0 || std::filesystem::exists(snapshotPath, error) || !std::filesystem::exists(LEGACY_PATH, error)) return;
+    std::filesystem::rename(LEGACY_PATH, snapshotPath, error);
+    if (error) {
+        std::cerr << "Error: Could not migrate " << LEGACY_PATH << ": " << error.message() << std::endl;
+        return;
+    }
+    if (std::filesystem::exists(LEGACY_JOURNAL_PATH, error)) {
+        std::filesystem::rename(LEGACY_JOURNAL_PATH, journalPath, error);
+        if (error) {
+            std::cerr << "Error: Could not migrate " << LEGACY_JOURNAL_PATH << ": " << error.message() << std::endl;
+        }
+    }
+}
+
+int Leaderboard::InsertEntry(std::string_view name, int totalSeconds) {
+    names.emplace_back(name);
+    ranks.Insert(totalSeconds);
+    return (int)names.size() - 1;
+}
+
+size_t Leaderboard::GetRecordRank() const {
+    if (recordIndex == RankTree::NONE) return 0;
+    return ranks.Rank(recordIndex) + 1;
+}
+
+std::vector<LeaderboardEntry> Leaderboard::GetRange(size_t firstRank, size_t count) const {
+    std::vector<int> indices;
+    if (firstRank > 0) ranks.Range(firstRank - 1, count, indices);
+
+    std::vector<LeaderboardEntry> result;
+    result.reserve(indices.size());
+    for (int index : indices) {
+        LeaderboardEntry entry;
+        entry.totalSeconds = ranks.GetSeconds(index);
+        entry.time = SecondsToTime(entry.totalSeconds);
+        entry.name = names[index];
+        entry.newRecord = (index == recordIndex);
+        result.push_back(entry);
+    }
+    return result;
+}
+
+// After a reload the tree is rebuilt, so look our submission up again: the newest entry with
+// the same name among those with the same time.
+void Leaderboard::FindRecord() {
+    recordIndex = RankTree::NONE;
+    if (recordSeconds < 0) return;
+
+    std::vector<int> indices;
+    size_t rank = ranks.LowerBound(recordSeconds);
+    while (rank < ranks.Size()) {
+        indices.clear();
+        ranks.Range(rank, 256, indices);
+        for (int index : indices) {
+            if (ranks.GetSeconds(index) != recordSeconds) return;
+            if (names[index] == recordName) recordIndex = index;
+        }
+        rank += indices.size();
+    }
+}
+
+// The snapshot holds every entry in rank order, headed by the last journal sequence folded
+// into it. The journal holds "seq,MM:SS,Name" lines appended since; replay skips any
+// sequence the snapshot already contains, so a crash mid-compaction is harmless.
 void Leaderboard::LoadLeaderboard() {
-    entries.clear();
-    std::ifstream file("files/leaderboard.txt");
-    std::string line;
-    if (!file.is_open()) return;
-
-    while (std::getline(file, line) && entries.size() < MAX_ENTRIES) {
-        size_t commaPos = line.find(',');
-        if (commaPos != std::string::npos) {
-            LeaderboardEntry entry;
-            entry.time = line.substr(0, commaPos);
-            entry.name = line.substr(commaPos + 1);
-            entry.totalSeconds = TimeToSeconds(entry.time);
-            entry.newRecord = false;
-            entries.push_back(entry);
+    TRACE_SCOPE("Leaderboard::LoadLeaderboard");
+    LeaderboardLock lock(lockPath, false);
+    ReadFromDisk();
+}
+
+bool Leaderboard::Refresh() {
+    if (!FilesChanged()) return false;
+    LoadLeaderboard();
+    return true;
+}
+
+Leaderboard::FileStamp Leaderboard::StampOf(const std::string& path) {
+    FileStamp stamp;
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return stamp;
+    stamp.inode = info.st_ino;
+    stamp.size = info.st_size;
+#ifdef __APPLE__
+    stamp.modifiedNanos = (long long)info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    stamp.modifiedNanos = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    return stamp;
+}
+
+bool Leaderboard::FilesChanged() const {
+    return !(StampOf(snapshotPath) == snapshotStamp) || !(StampOf(journalPath) == journalStamp);
+}
+
+void Leaderboard::RecordStamps() {
+    snapshotStamp = StampOf(snapshotPath);
+    journalStamp = StampOf(journalPath);
+}
+
+// Callers hold the lock, so no other process is halfway through writing either file.
+void Leaderboard::ReadFromDisk() {
+    RecordStamps();
+    ranks.Clear();
+    names.clear();
+    version++;
+    lastSequence = 0;
+    journalLength = 0;
+
+    // Both files are parsed straight out of the mapping; names short enough for the small
+    // string buffer (all of them, with the 10-character name limit) never touch the heap.
+    MappedFile snapshot(snapshotPath);
+    MappedFile journal(journalPath);
+    size_t estimatedEntries = (snapshot.View().size() + journal.View().size()) / 12;
+    ranks.Reserve(estimatedEntries);
+    names.reserve(estimatedEntries);
+
+    int malformed = 0;
+    std::string_view header(SEQUENCE_HEADER);
+    ForEachLine(snapshot.View(), true, [&](std::string_view line, size_t lineNumber) {
+        if (line.empty()) return;
+        if (line.substr(0, header.size()) == header) {
+            if (!ParseSequence(line.substr(header.size()), lastSequence)) ReportMalformed(snapshotPath, lineNumber, line, malformed);
+            return;
+        }
+        size_t comma = line.find(',');
+        int totalSeconds = 0;
+        if (comma == std::string_view::npos || !ParseTime(line.substr(0, comma), totalSeconds)) {
+            ReportMalformed(snapshotPath, lineNumber, line, malformed);
+            return;
+        }
+        InsertEntry(line.substr(comma + 1), totalSeconds);
+    });
+
+    // A journal line cut off by a crash has no trailing newline and is skipped.
+    ForEachLine(journal.View(), false, [&](std::string_view line, size_t lineNumber) {
+        if (line.empty()) return;
+        size_t firstComma = line.find(',');
+        size_t secondComma = firstComma == std::string_view::npos ? firstComma : line.find(',', firstComma + 1);
+        unsigned long long sequence = 0;
+        int totalSeconds = 0;
+        if (secondComma == std::string_view::npos ||
+            !ParseSequence(line.substr(0, firstComma), sequence) ||
+            !ParseTime(line.substr(firstComma + 1, secondComma - firstComma - 1), totalSeconds)) {
+            ReportMalformed(journalPath, lineNumber, line, malformed);
+            return;
         }
+        journalLength++;
+        if (sequence <= lastSequence) return;
+        lastSequence = sequence;
+        InsertEntry(line.substr(secondComma + 1), totalSeconds);
+    });
+
+    if (malformed > MAX_REPORTED_LINES) {
+        std::cerr << "Error: Skipped " << malformed << " malformed leaderboard lines in total!" << std::endl;
+    }
+    FindRecord();
+
+    // Boards from before the histogram existed get one built from their entries; the next
+    // submission writes it out.
+    if (!histogram.Load(histogramPath)) {
+        histogram.Clear();
+        for (size_t i = 0; i < ranks.Size(); ++i) histogram.Add((uint32_t)ranks.GetSeconds((int)i));
     }
-    file.close();
 }
 
-void Leaderboard::UpdateLeaderboard(const std::string& newName, long long newTimeSeconds) {
+bool Leaderboard::UpdateLeaderboard(const std::string& newName, long long newTimeSeconds) {
     LeaderboardEntry newEntry;
     newEntry.name = newName;
     newEntry.totalSeconds = (int)newTimeSeconds;
     newEntry.time = SecondsToTime((int)newTimeSeconds);
     newEntry.newRecord = true;
 
-    auto it = entries.begin();
-    while (it != entries.end() && it->totalSeconds <= newEntry.totalSeconds) {
-        it++;
+    // Read-modify-write under the exclusive lock: pick up whatever other instances wrote,
+    // then append with the next sequence number after theirs.
+    LeaderboardLock lock(lockPath, true);
+    if (FilesChanged()) ReadFromDisk();
+
+    // Only a score that reached the disk goes into the tree, so a failed append can't leave
+    // an entry that every published snapshot shows but no restart will find.
+    if (!AppendJournal(newEntry)) {
+        std::cerr << "Error: Could not append to " << journalPath << "!" << std::endl;
+        return false;
     }
+    recordName = newName;
+    recordSeconds = newEntry.totalSeconds;
+    recordIndex = InsertEntry(newName, newEntry.totalSeconds);
+    version++;
+    histogram.Add((uint32_t)newEntry.totalSeconds);
+    histogram.Save(histogramPath);
 
-    if (entries.size() < MAX_ENTRIES || it != entries.end()) {
-        entries.insert(it, newEntry);
-        if (entries.size() > MAX_ENTRIES) {
-            entries.pop_back();
-        }
+    // The snapshot now holds every entry, so compact in proportion to its size to keep the
+    // rewrite cost per submission constant.
+    if ((size_t)journalLength >= std::max<size_t>(COMPACT_THRESHOLD, ranks.Size() / 8)) {
         SaveLeaderboard();
     }
+    RecordStamps();
+    return true;
 }
 
+bool Leaderboard::AppendJournal(const LeaderboardEntry& entry) {
+    std::FILE* journal = std::fopen(journalPath.c_str(), "a");
+    if (!journal) return false;
+
+    std::string record = std::to_string(lastSequence + 1) + "," + entry.time + "," + entry.name + "\n";
+    bool written = std::fputs(record.c_str(), journal) >= 0 && SyncFile(journal);
+    std::fclose(journal);
+    if (written) {
+        lastSequence++;
+        journalLength++;
+    }
+    return written;
+}
+
+// Compaction: write the snapshot to a temp file, sync it, atomically rename it over the
+// old one, and only then empty the journal. Callers hold the exclusive lock.
 void Leaderboard::SaveLeaderboard() {
-    std::ofstream file("files/leaderboard.txt");
-    for (const auto& entry : entries) {
-        file << entry.time << "," << entry.name << "\n";
+    TRACE_SCOPE("Leaderboard::SaveLeaderboard");
+    std::string tempPath = snapshotPath + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error: Could not write " << tempPath << "!" << std::endl;
+        return;
+    }
+
+    bool written = std::fprintf(file, "%s%llu\n", SEQUENCE_HEADER, lastSequence) >= 0;
+    std::vector<int> indices;
+    for (size_t rank = 0; written && rank < ranks.Size(); rank += indices.size()) {
+        indices.clear();
+        ranks.Range(rank, 4096, indices);
+        for (int index : indices) {
+            std::string line = SecondsToTime(ranks.GetSeconds(index)) + "," + names[index] + "\n";
+            if (std::fputs(line.c_str(), file) < 0) written = false;
+        }
+    }
+    written = written && SyncFile(file);
+    std::fclose(file);
+
+    if (!written || std::rename(tempPath.c_str(), snapshotPath.c_str()) != 0) {
+        std::cerr << "Error: Could not replace " << snapshotPath << "!" << std::endl;
+        return;
+    }
+
+    std::FILE* journal = std::fopen(journalPath.c_str(), "w");
+    if (journal) {
+        SyncFile(journal);
+        std::fclose(journal);
+        journalLength = 0;
     }
-    file.close();
 }
 
-std::string Leaderboard::GetFormattedContent() {
-    std::string content = "LEADERBOARD\n\n";
+const std::string& Leaderboard::GetFormattedContent() {
+    if (formattedVersion == version) return formattedContent;
+    formattedVersion = version;
 
-    for (size_t i = 0; i < entries.size(); ++i) {
+    std::string& content = formattedContent;
+    content = "LEADERBOARD\n\n";
+
+    std::vector<LeaderboardEntry> top = GetRange(1, maxEntries);
+    for (size_t i = 0; i < top.size(); ++i) {
         content += std::to_string(i + 1) + ".\t";
-        content += entries[i].time + "\t";
-        content += entries[i].name;
-        if (entries[i].newRecord) {
+        content += top[i].time + "\t";
+        content += top[i].name;
+        if (top[i].newRecord) {
             content += "*";
         }
         content += "\n\n";
     }
+
+    if (histogram.GetTotalCount() > 0) {
+        content += "p50 " + SecondsToTime((int)histogram.GetPercentile(50)) +
+                   "  p90 " + SecondsToTime((int)histogram.GetPercentile(90)) +
+                   "  p99 " + SecondsToTime((int)histogram.GetPercentile(99)) + "\n\n";
+    }
+
+    // Outside the top list, still tell the player where they placed.
+    size_t recordRank = GetRecordRank();
+    if (recordRank > maxEntries) {
+        content += "You: #" + std::to_string(recordRank) + " of " + std::to_string(ranks.Size()) + "\n\n";
+    }
     return content;
 }
\ No newline at end of file
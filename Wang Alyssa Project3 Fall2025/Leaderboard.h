@@ -5,11 +5,22 @@
 #ifndef LEADERBOARD_H
 #define LEADERBOARD_H
 
+#include "CompletionHistogram.h"
+#include "RankTree.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 
+// Each board configuration (and each daily-challenge seed) has its own leaderboard.
+struct LeaderboardKey {
+    int columns = 0;
+    int rows = 0;
+    int mines = 0;
+    unsigned long long seed = 0;
+};
+
 struct LeaderboardEntry {
     std::string time;
     std::string name;
@@ -19,18 +30,77 @@ struct LeaderboardEntry {
 
 class Leaderboard {
 public:
-    Leaderboard();
+    explicit Leaderboard(const LeaderboardKey& key, int maxEntries = DEFAULT_MAX_ENTRIES);
     void LoadLeaderboard();
-    void UpdateLeaderboard(const std::string& newName, long long newTimeSeconds);
+    // Reloads only if another process changed the files since we last looked.
+    bool Refresh();
+    // Returns false if the score could not be persisted.
+    bool UpdateLeaderboard(const std::string& newName, long long newTimeSeconds);
     void SaveLeaderboard();
-    std::string GetFormattedContent();
+    const std::string& GetFormattedContent();
+    unsigned long long GetVersion() const { return version; }
+
+    // Every submission is kept; these are O(log n) in the number of entries.
+    size_t GetEntryCount() const { return ranks.Size(); }
+    // 1-based rank of this player's latest submission, or 0 if they haven't submitted.
+    size_t GetRecordRank() const;
+    std::vector<LeaderboardEntry> GetRange(size_t firstRank, size_t count) const;
+    size_t CountAtOrBelow(int totalSeconds) const { return ranks.LowerBound(totalSeconds + 1); }
+    const CompletionHistogram& GetHistogram() const { return histogram; }
+
+    static const int DEFAULT_MAX_ENTRIES = 5;
+    static const int MAX_SECONDS = 99 * 60 + 59;
+    static std::string StorePath(const LeaderboardKey& key);
 
 private:
-    std::vector<LeaderboardEntry> entries;
-    static const int MAX_ENTRIES = 5;
+    // names[i] belongs to tree entry i.
+    RankTree ranks;
+    std::vector<std::string> names;
+    static const int COMPACT_THRESHOLD = 64;
+
+    LeaderboardKey key;
+    size_t maxEntries;
+    std::string snapshotPath;
+    std::string journalPath;
+    std::string lockPath;
+    std::string histogramPath;
+    CompletionHistogram histogram;
+
+    // Cheap change detection: a journal append changes its size, a compaction renames a
+    // new snapshot into place, and either bumps the modification time.
+    struct FileStamp {
+        unsigned long long inode = 0;
+        long long size = -1;
+        long long modifiedNanos = 0;
+        bool operator==(const FileStamp& other) const {
+            return inode == other.inode && size == other.size && modifiedNanos == other.modifiedNanos;
+        }
+    };
+    FileStamp snapshotStamp;
+    FileStamp journalStamp;
+    static FileStamp StampOf(const std::string& path);
+    bool FilesChanged() const;
+    void RecordStamps();
+
+    // Our latest submission stays starred after reloads pick up other processes' scores.
+    std::string recordName;
+    int recordSeconds = -1;
+    int recordIndex = RankTree::NONE;
+    void FindRecord();
+
+    unsigned long long lastSequence = 0;
+    int journalLength = 0;
+
+    unsigned long long version = 0;
+    unsigned long long formattedVersion = 0;
+    std::string formattedContent;
 
-    int TimeToSeconds(const std::string& timeStr);
-    std::string SecondsToTime(int totalSeconds);
+    void ReadFromDisk();
+    int InsertEntry(std::string_view name, int totalSeconds);
+    bool AppendJournal(const LeaderboardEntry& entry);
+    void MigrateLegacyLeaderboard();
+    static bool ParseTime(std::string_view text, int& totalSeconds);
+    static std::string SecondsToTime(int totalSeconds);
 };
 
 #endif
\ No newline at end of file
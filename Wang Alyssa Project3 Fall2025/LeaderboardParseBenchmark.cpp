@@ -0,0 +1,130 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// LeaderboardParseBenchmark [lines]
+// Writes a snapshot of the given number of entries (5,000,000 by default) under
+// files/leaderboards in the current directory, in rank order the way compaction writes it,
+// then times loading it through the Leaderboard constructor and reports lines per second.
+// Before that it loads a small board seeded with malformed and torn lines and exits with 1
+// if any of them got in or a good line was lost.
+
+#include "Leaderboard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int LOAD_RUNS = 3;
+
+static void RemoveBoard(const LeaderboardKey& key) {
+    std::error_code error;
+    std::string base = Leaderboard::StorePath(key);
+    for (const char* suffix : {".txt", ".journal", ".lock", ".hist"}) {
+        std::filesystem::remove(base + suffix, error);
+    }
+}
+
+static std::string TimeText(int totalSeconds) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%02d:%02d", totalSeconds / 60, totalSeconds % 60);
+    return text;
+}
+
+// Every line that must be rejected, next to good lines that must all survive.
+static bool RejectsMalformedLines() {
+    LeaderboardKey key = {9, 9, 10, 43};
+    RemoveBoard(key);
+    std::filesystem::create_directories(std::filesystem::path(Leaderboard::StorePath(key)).parent_path());
+    {
+        std::ofstream snapshot(Leaderboard::StorePath(key) + ".txt", std::ios::binary);
+        snapshot << "#seq 2\n"
+                 << "00:07,Good1\n"
+                 << "01:-5,Bad\n"
+                 << "-1:05,Bad\n"
+                 << "00:-0,Bad\n"
+                 << "01:60,Bad\n"
+                 << "1:5x,Bad\n"
+                 << "35791395:00,Bad\n"
+                 << "99999999999:00,Bad\n"
+                 << "0105,Bad\n"
+                 << ",Bad\n"
+                 << "\n"
+                 << "99:59,Good2\r\n"
+                 << "00:30,Good3";
+        std::ofstream journal(Leaderboard::StorePath(key) + ".journal", std::ios::binary);
+        journal << "2,00:01,Old\n"
+                << "3,00:02,Good4\n"
+                << "x,00:03,Bad\n"
+                << "4,00:04\n"
+                << "5,00:05,Torn";
+    }
+
+    Leaderboard leaderboard(key);
+    std::vector<LeaderboardEntry> entries = leaderboard.GetRange(1, leaderboard.GetEntryCount());
+    RemoveBoard(key);
+    const char* expected[] = {"Good4", "Good1", "Good3", "Good2"};
+    bool matches = entries.size() == 4;
+    for (size_t i = 0; matches && i < entries.size(); ++i) {
+        matches = entries[i].name == expected[i];
+    }
+    if (!matches) {
+        std::fprintf(stderr, "Error: The malformed-line board loaded %zu entries instead of Good1-4!\n", entries.size());
+    }
+    return matches;
+}
+
+int main(int argc, char* argv[]) {
+    size_t lines = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    if (lines == 0) {
+        std::fprintf(stderr, "Error: The line count must be positive!\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "Malformed lines below are expected:\n");
+    if (!RejectsMalformedLines()) return 1;
+    std::printf("malformed lines: all rejected\n");
+
+    LeaderboardKey key = {30, 16, 99, 43};
+    RemoveBoard(key);
+    std::filesystem::create_directories(std::filesystem::path(Leaderboard::StorePath(key)).parent_path());
+    {
+        // Random times, sorted, so the file looks like a compacted snapshot.
+        std::mt19937 random(43);
+        std::uniform_int_distribution<int> seconds(0, Leaderboard::MAX_SECONDS);
+        std::vector<int> times(lines);
+        for (int& time : times) time = seconds(random);
+        std::sort(times.begin(), times.end());
+
+        std::ofstream snapshot(Leaderboard::StorePath(key) + ".txt", std::ios::binary);
+        std::string line;
+        for (size_t i = 0; i < lines; ++i) {
+            line = TimeText(times[i]);
+            line += ",P";
+            line += std::to_string(i % 100000000);
+            line += '\n';
+            snapshot << line;
+        }
+    }
+
+    double best = 0;
+    for (int run = 0; run < LOAD_RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        Leaderboard leaderboard(key);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (leaderboard.GetEntryCount() != lines) {
+            std::fprintf(stderr, "Error: Loaded %zu of %zu lines!\n", leaderboard.GetEntryCount(), lines);
+            RemoveBoard(key);
+            return 1;
+        }
+        std::printf("load %d: %.3f s, %.2fM lines/s\n", run + 1, elapsed, lines / elapsed / 1e6);
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    std::printf("best: %.2fM lines/s over %zu lines\n", lines / best / 1e6, lines);
+    RemoveBoard(key);
+    return 0;
+}
@@ -0,0 +1,167 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "LeaderboardService.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+
+// How often the idle I/O thread checks whether another game instance changed the files.
+static const std::chrono::milliseconds REFRESH_INTERVAL(500);
+
+size_t LeaderboardSnapshot::ProvisionalRank(int totalSeconds) const {
+    if (entriesAtOrBelow.empty()) return 1;
+    size_t second = (size_t)std::clamp(totalSeconds, 0, (int)entriesAtOrBelow.size() - 1);
+    return entriesAtOrBelow[second] + 1;
+}
+
+LeaderboardService::~LeaderboardService() {
+    Stop();
+}
+
+void LeaderboardService::Start(const LeaderboardKey& key, int maxEntries, unsigned int verifierThreads, const std::string& statsPath) {
+    Stop();
+    stopping = false;
+    this->key = key;
+    this->statsPath = statsPath;
+    verifier.Start(verifierThreads);
+    thread = std::thread(&LeaderboardService::Run, this, maxEntries);
+}
+
+// The verifier goes first: replays still in flight queue their submissions on the way out.
+void LeaderboardService::Stop() {
+    verifier.Stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+size_t LeaderboardService::Submit(const std::string& name, int totalSeconds, GameReplay replay, CompletionFunction onComplete) {
+    size_t rank = GetSnapshot()->ProvisionalRank(totalSeconds);
+
+    // A replay must be of this leaderboard's board; daily boards also pin the seed.
+    if (replay.columns != key.columns || replay.rows != key.rows || replay.mines != key.mines ||
+        (key.seed != 0 && replay.seed != key.seed)) {
+        Reject(REPLAY_BAD_BOARD, std::move(onComplete));
+        return rank;
+    }
+
+    verifier.Submit(std::move(replay), totalSeconds, [this, name, totalSeconds, onComplete](ReplayVerdict verdict) {
+        if (verdict != REPLAY_ACCEPTED) {
+            Reject(verdict, onComplete);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            submissions.push_back({name, totalSeconds, onComplete});
+        }
+        wakeup.notify_all();
+    });
+    return rank;
+}
+
+void LeaderboardService::RecordGame(const std::string& name, bool won, int seconds, int bv3, StatsFunction onComplete) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishedGames.push_back({name, won, seconds, bv3, std::move(onComplete)});
+    }
+    wakeup.notify_all();
+}
+
+void LeaderboardService::Reject(ReplayVerdict verdict, CompletionFunction onComplete) {
+    LeaderboardResult result;
+    result.verdict = verdict;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (onComplete) completions.emplace_back(std::move(onComplete), result);
+}
+
+void LeaderboardService::PollCompletions() {
+    std::vector<std::pair<CompletionFunction, LeaderboardResult>> finished;
+    std::vector<std::pair<StatsFunction, PlayerStatsResult>> finishedStats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (completions.empty() && statsCompletions.empty()) return;
+        finished.swap(completions);
+        finishedStats.swap(statsCompletions);
+    }
+    for (auto& completion : finished) {
+        completion.first(completion.second);
+    }
+    for (auto& completion : finishedStats) {
+        completion.first(completion.second);
+    }
+}
+
+std::shared_ptr<const LeaderboardSnapshot> LeaderboardService::GetSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return snapshot;
+}
+
+// Everything touching the Leaderboard or the PlayerStats file, including their first
+// loads, happens on this thread.
+void LeaderboardService::Run(int maxEntries) {
+    Leaderboard leaderboard(key, maxEntries);
+    Publish(leaderboard);
+    PlayerStats playerStats;
+    if (!statsPath.empty()) playerStats.Open(statsPath);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeup.wait_for(lock, REFRESH_INTERVAL, [this]() { return stopping || !submissions.empty() || !finishedGames.empty(); });
+        if (!finishedGames.empty()) {
+            FinishedGame game = std::move(finishedGames.front());
+            finishedGames.pop_front();
+            lock.unlock();
+
+            PlayerStatsResult result;
+            const PlayerRecord* record = playerStats.RecordGame(game.name, key, game.won, game.seconds, game.bv3);
+            if (record) {
+                result.saved = true;
+                result.record = *record;
+            }
+
+            lock.lock();
+            if (game.onComplete) statsCompletions.emplace_back(std::move(game.onComplete), result);
+            continue;
+        }
+        if (submissions.empty()) {
+            if (stopping) break;
+            lock.unlock();
+            if (leaderboard.Refresh()) Publish(leaderboard);
+            lock.lock();
+            continue;
+        }
+
+        Submission submission = std::move(submissions.front());
+        submissions.pop_front();
+        lock.unlock();
+
+        LeaderboardResult result;
+        result.saved = leaderboard.UpdateLeaderboard(submission.name, submission.totalSeconds);
+        result.rank = leaderboard.GetRecordRank();
+        result.entryCount = leaderboard.GetEntryCount();
+        Publish(leaderboard);
+
+        lock.lock();
+        if (submission.onComplete) completions.emplace_back(std::move(submission.onComplete), result);
+    }
+}
+
+void LeaderboardService::Publish(Leaderboard& leaderboard) {
+    TRACE_SCOPE("LeaderboardService::Publish");
+    auto next = std::make_shared<LeaderboardSnapshot>();
+    next->version = leaderboard.GetVersion();
+    next->content = leaderboard.GetFormattedContent();
+    next->entryCount = leaderboard.GetEntryCount();
+    next->entriesAtOrBelow.resize(Leaderboard::MAX_SECONDS + 1);
+    for (int second = 0; second <= Leaderboard::MAX_SECONDS; ++second) {
+        next->entriesAtOrBelow[second] = leaderboard.CountAtOrBelow(second);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshot = std::move(next);
+}
@@ -0,0 +1,99 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_LEADERBOARDSERVICE_H
+#define MINESWEEPER_LEADERBOARDSERVICE_H
+
+#include "Leaderboard.h"
+#include "PlayerStats.h"
+#include "Replay.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What the render thread gets to see of the leaderboard: the formatted text, plus how many
+// entries beat each possible time so a new score can be ranked without touching the store.
+struct LeaderboardSnapshot {
+    unsigned long long version = 0;
+    std::string content = "LEADERBOARD\n\n";
+    size_t entryCount = 0;
+    std::vector<size_t> entriesAtOrBelow;
+
+    size_t ProvisionalRank(int totalSeconds) const;
+};
+
+struct LeaderboardResult {
+    ReplayVerdict verdict = REPLAY_ACCEPTED;
+    bool saved = false;
+    size_t rank = 0;
+    size_t entryCount = 0;
+};
+
+// A copy of the player's updated record; the store itself stays on the I/O thread.
+struct PlayerStatsResult {
+    bool saved = false;
+    PlayerRecord record;
+};
+
+// Owns the Leaderboard and the PlayerStats file on a dedicated I/O thread, so loading, file
+// locks, journal syncs and compaction never happen inside the frame loop. Every submission
+// is first replayed by the verifier pool and only then queued for the store; completion
+// callbacks run on whichever thread calls PollCompletions().
+class LeaderboardService {
+public:
+    using CompletionFunction = std::function<void(const LeaderboardResult&)>;
+    using StatsFunction = std::function<void(const PlayerStatsResult&)>;
+
+    ~LeaderboardService();
+    // An empty statsPath leaves per-player statistics off.
+    void Start(const LeaderboardKey& key, int maxEntries, unsigned int verifierThreads = 1, const std::string& statsPath = "");
+    // Drains queued submissions and games before the thread exits.
+    void Stop();
+
+    // Returns the provisional rank straight away; the score is verified and persisted in
+    // the background.
+    size_t Submit(const std::string& name, int totalSeconds, GameReplay replay, CompletionFunction onComplete);
+    // Adds one finished game, won or lost, to the player's statistics for this board.
+    void RecordGame(const std::string& name, bool won, int seconds, int bv3, StatsFunction onComplete);
+    void PollCompletions();
+    std::shared_ptr<const LeaderboardSnapshot> GetSnapshot();
+
+private:
+    struct Submission {
+        std::string name;
+        int totalSeconds;
+        CompletionFunction onComplete;
+    };
+    struct FinishedGame {
+        std::string name;
+        bool won;
+        int seconds;
+        int bv3;
+        StatsFunction onComplete;
+    };
+
+    LeaderboardKey key;
+    std::string statsPath;
+    ReplayVerifier verifier;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+    std::deque<Submission> submissions;
+    std::deque<FinishedGame> finishedGames;
+    std::vector<std::pair<CompletionFunction, LeaderboardResult>> completions;
+    std::vector<std::pair<StatsFunction, PlayerStatsResult>> statsCompletions;
+    std::shared_ptr<const LeaderboardSnapshot> snapshot = std::make_shared<LeaderboardSnapshot>();
+
+    void Run(int maxEntries);
+    void Reject(ReplayVerdict verdict, CompletionFunction onComplete);
+    void Publish(Leaderboard& leaderboard);
+};
+
+#endif //MINESWEEPER_LEADERBOARDSERVICE_H
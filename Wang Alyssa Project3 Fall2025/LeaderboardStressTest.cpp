@@ -0,0 +1,105 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// LeaderboardStressTest [processes] [scores per process]
+// Forks that many processes (24 by default), each submitting that many scores (60) to one
+// board under files/leaderboards in the current directory, the way several game instances
+// share a leaderboard. Afterwards every score must be there exactly once and a Leaderboard
+// opened before the run must notice the change through Refresh(). Exits with 1 otherwise.
+
+#include "Leaderboard.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string ScoreName(int process, int score) {
+    return "P" + std::to_string(process) + "-" + std::to_string(score);
+}
+
+// Runs in the child: one Leaderboard per process, like one game instance.
+static int SubmitScores(const LeaderboardKey& key, int process, int scores) {
+    Leaderboard leaderboard(key);
+    for (int score = 0; score < scores; ++score) {
+        int totalSeconds = (process * 7919 + score * 104729) % (Leaderboard::MAX_SECONDS + 1);
+        if (!leaderboard.UpdateLeaderboard(ScoreName(process, score), totalSeconds)) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int processes = argc > 1 ? std::atoi(argv[1]) : 24;
+    int scores = argc > 2 ? std::atoi(argv[2]) : 60;
+    if (processes <= 0 || scores <= 0 || processes > 9999 || scores > 99999) {
+        std::fprintf(stderr, "Error: Use 1-9999 processes and 1-99999 scores each!\n");
+        return 1;
+    }
+
+    LeaderboardKey key = {8, 8, 10, 40};
+    std::string base = Leaderboard::StorePath(key);
+    std::error_code error;
+    for (const char* suffix : {".txt", ".journal", ".lock", ".hist"}) {
+        std::filesystem::remove(base + suffix, error);
+    }
+
+    Leaderboard watcher(key);
+    if (watcher.Refresh()) {
+        std::fprintf(stderr, "Error: Refresh() reported a change before anything was written!\n");
+        return 1;
+    }
+
+    std::fflush(stdout);
+    std::vector<pid_t> children;
+    for (int process = 0; process < processes; ++process) {
+        pid_t child = fork();
+        if (child < 0) {
+            std::fprintf(stderr, "Error: Could not fork!\n");
+            return 1;
+        }
+        if (child == 0) _exit(SubmitScores(key, process, scores));
+        children.push_back(child);
+    }
+
+    bool childrenOk = true;
+    for (pid_t child : children) {
+        int status = 0;
+        if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) childrenOk = false;
+    }
+    if (!childrenOk) {
+        std::fprintf(stderr, "Error: A submitting process failed!\n");
+        return 1;
+    }
+
+    if (!watcher.Refresh()) {
+        std::fprintf(stderr, "Error: Refresh() missed the other processes' scores!\n");
+        return 1;
+    }
+
+    // A fresh load reads the files from scratch, independent of the watcher's reloads.
+    Leaderboard reloaded(key);
+    size_t expected = (size_t)processes * scores;
+    std::set<std::string> names;
+    for (const LeaderboardEntry& entry : reloaded.GetRange(1, reloaded.GetEntryCount())) {
+        names.insert(entry.name);
+    }
+    bool allThere = reloaded.GetEntryCount() == expected && watcher.GetEntryCount() == expected && names.size() == expected;
+    for (int process = 0; allThere && process < processes; ++process) {
+        for (int score = 0; allThere && score < scores; ++score) {
+            allThere = names.count(ScoreName(process, score)) == 1;
+        }
+    }
+    if (!allThere) {
+        std::fprintf(stderr, "Error: Expected %zu scores, found %zu (%zu distinct, watcher %zu)!\n",
+                     expected, reloaded.GetEntryCount(), names.size(), watcher.GetEntryCount());
+        return 1;
+    }
+
+    std::printf("%d processes x %d scores: all %zu entries present\n", processes, scores, expected);
+    for (const char* suffix : {".txt", ".journal", ".lock", ".hist"}) {
+        std::filesystem::remove(base + suffix, error);
+    }
+    return 0;
+}
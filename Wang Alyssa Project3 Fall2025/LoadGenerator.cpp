@@ -0,0 +1,233 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// MinesweeperLoad <address> [connections] [sessions per connection] [seconds] [threads] [moves per request]
+// Plays expert games against a MinesweeperServer as fast as it will answer and reports the
+// move rate. Each round sends one request for every session on every connection before
+// reading any replies, so the server always sees deep pipelines. The connections are split
+// across the client threads so the generator can keep a sharded server busy. With more than
+// one move per request, moves go out as MOVES batches the way a bot would send them. Each
+// session follows its board through the frames in the replies and never clicks a cell it
+// can already see.
+
+#include "ServerProtocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const int COLUMNS = 30;
+static const int ROWS = 16;
+static const int MINES = 99;
+
+struct LoadSession {
+    uint32_t id = 0;
+    bool playing = false;
+    // Cells not clicked yet this game; the next click takes a random one that still looks
+    // hidden (or flagged) in view.
+    std::vector<int> unclicked;
+    StateStreamReader view;
+};
+
+struct LoadConnection {
+    int fd = -1;
+    std::vector<LoadSession> sessions;
+    std::vector<uint8_t> output;
+    std::vector<uint8_t> input;
+};
+
+struct LoadTotals {
+    unsigned long long moves = 0;
+    unsigned long long games = 0;
+    unsigned long long wins = 0;
+    unsigned long long errors = 0;
+    bool failed = false;
+};
+
+static bool SendAll(int fd, const std::vector<uint8_t>& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        sent += written;
+    }
+    return true;
+}
+
+// Applies the stream frame that ends a reply, if the action changed anything. A frame the
+// view can't follow is an error; the session then starts a new game.
+static bool FollowBoard(LoadSession& session, MessageReader& reply, LoadTotals& totals) {
+    size_t size = reply.GetRemaining();
+    const uint8_t* frame = reply.GetBytes(size);
+    if (!reply.IsValid() || (size > 0 && !session.view.Apply(frame, size)) || !session.view.IsSynced()) {
+        totals.errors++;
+        return false;
+    }
+    return true;
+}
+
+// One client thread: plays every session of its connections until the deadline.
+static void PlayRounds(std::vector<LoadConnection>& connections, unsigned int seed, int batchSize,
+                       std::chrono::steady_clock::time_point end, LoadTotals& totals) {
+    std::mt19937 random(seed);
+    std::vector<MineField::Move> moves;
+    while (std::chrono::steady_clock::now() < end) {
+        for (LoadConnection& connection : connections) {
+            connection.output.clear();
+            for (LoadSession& session : connection.sessions) {
+                // Mostly reveals, with the odd flag so both paths get exercised.
+                moves.clear();
+                while (session.playing && moves.size() < (size_t)batchSize && !session.unclicked.empty()) {
+                    size_t pick = random() % session.unclicked.size();
+                    int cell = session.unclicked[pick];
+                    bool flag = random() % 8 == 0;
+                    // Cells an earlier reply showed revealed, by a flood fill, say, are dropped.
+                    bool revealed = session.view.GetCells()[cell] <= 8;
+                    if (!revealed) moves.push_back({cell, flag ? MineField::MOVE_FLAG : MineField::MOVE_REVEAL});
+                    if (revealed || !flag) {
+                        session.unclicked[pick] = session.unclicked.back();
+                        session.unclicked.pop_back();
+                    }
+                }
+                if (moves.empty()) {
+                    size_t message = BeginMessage(connection.output, MSG_NEW_GAME, session.id);
+                    PutU16(connection.output, COLUMNS);
+                    PutU16(connection.output, ROWS);
+                    PutU32(connection.output, MINES);
+                    PutU64(connection.output, 0);
+                    EndMessage(connection.output, message);
+                    continue;
+                }
+                if (moves.size() == 1) {
+                    size_t message = BeginMessage(connection.output, moves[0].kind == MineField::MOVE_FLAG ? MSG_FLAG : MSG_REVEAL, session.id);
+                    PutU32(connection.output, (uint32_t)moves[0].cell);
+                    EndMessage(connection.output, message);
+                    continue;
+                }
+                size_t message = BeginMessage(connection.output, MSG_MOVES, session.id);
+                PutU16(connection.output, (uint16_t)moves.size());
+                for (const MineField::Move& move : moves) {
+                    PutU8(connection.output, move.kind);
+                    PutU32(connection.output, (uint32_t)move.cell);
+                }
+                EndMessage(connection.output, message);
+            }
+            if (!SendAll(connection.fd, connection.output)) {
+                std::cerr << "Error: Lost the connection to the server!" << std::endl;
+                totals.failed = true;
+                return;
+            }
+        }
+
+        // Replies come back in request order, one per session.
+        for (LoadConnection& connection : connections) {
+            size_t offset = 0;
+            for (LoadSession& session : connection.sessions) {
+                size_t frameSize;
+                while ((frameSize = CompleteFrameSize(connection.input.data() + offset, connection.input.size() - offset)) == 0) {
+                    size_t used = connection.input.size();
+                    connection.input.resize(used + 64 * 1024);
+                    ssize_t received = recv(connection.fd, connection.input.data() + used, 64 * 1024, 0);
+                    connection.input.resize(used + (received > 0 ? received : 0));
+                    if (received < 0 && errno == EINTR) continue;
+                    if (received <= 0) {
+                        std::cerr << "Error: Lost the connection to the server!" << std::endl;
+                        totals.failed = true;
+                        return;
+                    }
+                }
+
+                MessageReader reply(connection.input.data() + offset + FRAME_HEADER_BYTES, frameSize - FRAME_HEADER_BYTES);
+                offset += frameSize;
+                uint8_t type = reply.GetU8();
+                uint32_t sessionId = reply.GetU32();
+                if (type == MSG_GAME_STARTED) {
+                    session.id = sessionId;
+                    reply.GetU64();
+                    session.playing = FollowBoard(session, reply, totals);
+                    session.unclicked.resize(COLUMNS * ROWS);
+                    for (int i = 0; i < COLUMNS * ROWS; ++i) session.unclicked[i] = i;
+                    totals.games++;
+                } else if (type == MSG_MOVE_RESULT || type == MSG_MOVES_RESULT) {
+                    uint8_t state = reply.GetU8();
+                    if (state == MineField::WIN) totals.wins++;
+                    totals.moves += (type == MSG_MOVES_RESULT) ? reply.GetU16() : 1;
+                    if (type == MSG_MOVE_RESULT) reply.GetU32();
+                    session.playing = FollowBoard(session, reply, totals) && state == MineField::PLAYING;
+                } else {
+                    totals.errors++;
+                    session.playing = false;
+                }
+            }
+            connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: MinesweeperLoad <address> [connections] [sessions per connection] [seconds] [threads] [moves per request]" << std::endl;
+        return 1;
+    }
+    std::string address = argv[1];
+    int connectionCount = argc > 2 ? std::atoi(argv[2]) : 16;
+    int sessionsPerConnection = argc > 3 ? std::atoi(argv[3]) : 256;
+    int seconds = argc > 4 ? std::atoi(argv[4]) : 10;
+    int threadCount = argc > 5 ? std::atoi(argv[5]) : 1;
+    int batchSize = argc > 6 ? std::atoi(argv[6]) : 1;
+    if (connectionCount <= 0 || sessionsPerConnection <= 0 || seconds <= 0 || threadCount <= 0 || batchSize <= 0) {
+        std::cerr << "Error: Counts must be positive!" << std::endl;
+        return 1;
+    }
+    if (batchSize > (int)MAX_BATCH_MOVES) {
+        std::cerr << "Error: At most " << MAX_BATCH_MOVES << " moves fit in one request!" << std::endl;
+        return 1;
+    }
+
+    threadCount = std::min(threadCount, connectionCount);
+    std::vector<std::vector<LoadConnection>> groups(threadCount);
+    for (int i = 0; i < connectionCount; ++i) {
+        LoadConnection connection;
+        connection.fd = ConnectTo(address);
+        if (connection.fd < 0) return 1;
+        connection.sessions.resize(sessionsPerConnection);
+        groups[i % threadCount].push_back(std::move(connection));
+    }
+
+    std::vector<LoadTotals> totals(threadCount);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(PlayRounds, std::ref(groups[i]), 12345u + i, batchSize, end, std::ref(totals[i]));
+    }
+    LoadTotals sum;
+    for (int i = 0; i < threadCount; ++i) {
+        threads[i].join();
+        sum.moves += totals[i].moves;
+        sum.games += totals[i].games;
+        sum.wins += totals[i].wins;
+        sum.errors += totals[i].errors;
+        sum.failed = sum.failed || totals[i].failed;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%d connections x %d sessions on %d threads, %d moves per request, %.1f s\n",
+                connectionCount, sessionsPerConnection, threadCount, batchSize, elapsed);
+    std::printf("%llu moves (%.0f/s), %llu games (%.0f/s), %llu wins, %llu errors\n",
+                sum.moves, sum.moves / elapsed, sum.games, sum.games / elapsed, sum.wins, sum.errors);
+    for (auto& group : groups) {
+        for (LoadConnection& connection : group) close(connection.fd);
+    }
+    return (sum.errors == 0 && !sum.failed) ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "Metrics.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+struct CounterInfo {
+    const char* name;
+    const char* help;
+    bool isGauge;
+};
+
+const CounterInfo COUNTERS[Metrics::COUNTER_COUNT] = {
+    {"minesweeper_clicks_total", "Left clicks on the board, including ones that revealed nothing.", false},
+    {"minesweeper_tiles_revealed_total", "Tiles revealed by left clicks, including flood fills.", false},
+    {"minesweeper_flood_fill_peak_frontier", "Largest flood-fill frontier seen.", true},
+    {"minesweeper_mines_placed_total", "Mines placed by board initialization.", false},
+    {"minesweeper_initialize_total", "Board::Initialize calls.", false},
+    {"minesweeper_initialize_microseconds_total", "Time spent in Board::Initialize.", false},
+    {"minesweeper_restart_total", "Board::Restart calls.", false},
+    {"minesweeper_restart_microseconds_total", "Time spent in Board::Restart.", false},
+    {"minesweeper_frames_total", "Frames drawn.", false},
+    {"minesweeper_draw_calls_total", "Draw calls issued.", false},
+    {"minesweeper_vertices_total", "Vertices submitted by sprite, quad and vertex-array draws.", false},
+    {"minesweeper_frame_allocations_total", "Heap allocations made while drawing frames.", false},
+    {"minesweeper_frame_allocated_bytes_total", "Bytes allocated while drawing frames.", false},
+    {"minesweeper_action_allocations_total", "Heap allocations made while handling input.", false},
+    {"minesweeper_action_allocated_bytes_total", "Bytes allocated while handling input.", false},
+};
+
+struct CounterBlock {
+    std::array<std::atomic<uint64_t>, Metrics::COUNTER_COUNT> values{};
+};
+
+std::mutex& RegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<CounterBlock*>& Registry() {
+    static std::vector<CounterBlock*> registry;
+    return registry;
+}
+
+// Totals from threads that have already exited.
+CounterBlock& Retired() {
+    static CounterBlock retired;
+    return retired;
+}
+
+void Fold(CounterBlock& into, const CounterBlock& from) {
+    for (int i = 0; i < Metrics::COUNTER_COUNT; ++i) {
+        uint64_t value = from.values[i].load(std::memory_order_relaxed);
+        uint64_t current = into.values[i].load(std::memory_order_relaxed);
+        into.values[i].store(COUNTERS[i].isGauge ? std::max(current, value) : current + value, std::memory_order_relaxed);
+    }
+}
+
+struct ThreadSlot {
+    CounterBlock block;
+
+    ThreadSlot() {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        Registry().push_back(&block);
+    }
+
+    ~ThreadSlot() {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        Fold(Retired(), block);
+        auto& registry = Registry();
+        for (size_t i = 0; i < registry.size(); ++i) {
+            if (registry[i] == &block) {
+                registry[i] = registry.back();
+                registry.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+CounterBlock& Local() {
+    thread_local ThreadSlot slot;
+    return slot.block;
+}
+
+}
+
+// Only the owning thread writes its block, so a relaxed load + store is enough.
+void Metrics::Add(Counter counter, uint64_t value) {
+    std::atomic<uint64_t>& slot = Local().values[counter];
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void Metrics::Max(Counter counter, uint64_t value) {
+    std::atomic<uint64_t>& slot = Local().values[counter];
+    if (value > slot.load(std::memory_order_relaxed)) slot.store(value, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::Get(Counter counter) {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    CounterBlock total;
+    Fold(total, Retired());
+    for (CounterBlock* block : Registry()) Fold(total, *block);
+    return total.values[counter].load(std::memory_order_relaxed);
+}
+
+std::string Metrics::FormatPrometheus() {
+    CounterBlock total;
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        Fold(total, Retired());
+        for (CounterBlock* block : Registry()) Fold(total, *block);
+    }
+
+    std::string out;
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        out += std::string("# HELP ") + COUNTERS[i].name + " " + COUNTERS[i].help + "\n";
+        out += std::string("# TYPE ") + COUNTERS[i].name + (COUNTERS[i].isGauge ? " gauge\n" : " counter\n");
+        out += std::string(COUNTERS[i].name) + " " + std::to_string(total.values[i].load(std::memory_order_relaxed)) + "\n";
+    }
+    return out;
+}
+
+bool Metrics::WritePrometheus(const std::string& path) {
+    // The scraper must never see a half-written file.
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath);
+        if (!file.is_open()) return false;
+        file << FormatPrometheus();
+        if (!file.good()) return false;
+    }
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+void MetricsExporter::Start(const std::string& path, int intervalSeconds) {
+    Stop();
+    stopping = false;
+    thread = std::thread([this, path, intervalSeconds]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            wakeup.wait_for(lock, std::chrono::seconds(intervalSeconds));
+            Metrics::WritePrometheus(path);
+        }
+    });
+}
+
+void MetricsExporter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (thread.joinable()) thread.join();
+}
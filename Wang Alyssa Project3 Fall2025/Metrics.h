@@ -0,0 +1,75 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_METRICS_H
+#define MINESWEEPER_METRICS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Engine hot-path counters. Each thread bumps its own block without contention; reads sum
+// (or take the max of) every thread's block. Build without MINESWEEPER_METRICS and the
+// METRIC_* macros compile to nothing.
+#ifdef MINESWEEPER_METRICS
+#define METRIC_ADD(counter, value) Metrics::Add(Metrics::counter, (value))
+#define METRIC_MAX(counter, value) Metrics::Max(Metrics::counter, (value))
+#define METRIC_DRAW(vertices) (Metrics::Add(Metrics::DRAW_CALLS, 1), Metrics::Add(Metrics::VERTICES, (vertices)))
+#define METRIC_TIME_SCOPE(counter) MetricsScopedTimer metricsScopedTimer(Metrics::counter)
+#else
+#define METRIC_ADD(counter, value) ((void)0)
+#define METRIC_MAX(counter, value) ((void)0)
+#define METRIC_DRAW(vertices) ((void)0)
+#define METRIC_TIME_SCOPE(counter) ((void)0)
+#endif
+
+class Metrics {
+public:
+    enum Counter {
+        CLICKS, TILES_REVEALED, FLOOD_FILL_PEAK_FRONTIER, MINES_PLACED,
+        INITIALIZE_COUNT, INITIALIZE_MICROS, RESTART_COUNT, RESTART_MICROS,
+        FRAMES, DRAW_CALLS, VERTICES,
+        FRAME_ALLOCATIONS, FRAME_ALLOCATED_BYTES, ACTION_ALLOCATIONS, ACTION_ALLOCATED_BYTES,
+        COUNTER_COUNT
+    };
+
+    static void Add(Counter counter, uint64_t value);
+    static void Max(Counter counter, uint64_t value);
+    static uint64_t Get(Counter counter);
+    static std::string FormatPrometheus();
+    static bool WritePrometheus(const std::string& path);
+};
+
+// Adds the microseconds spent in the enclosing scope to a counter.
+class MetricsScopedTimer {
+public:
+    explicit MetricsScopedTimer(Metrics::Counter counter) : counter(counter), start(std::chrono::steady_clock::now()) {}
+    ~MetricsScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Metrics::Add(counter, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+private:
+    Metrics::Counter counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Periodically rewrites a Prometheus text-format file (temp file + rename) on its own thread.
+class MetricsExporter {
+public:
+    ~MetricsExporter();
+    void Start(const std::string& path, int intervalSeconds);
+    void Stop();
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,180 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "MineField.h"
+#include "Trace.h"
+#include <algorithm>
+#include <random>
+
+void MineField::Initialize(int columns, int rows, int mines, unsigned long long seed) {
+    this->columns = columns;
+    this->rows = rows;
+    this->seed = seed;
+    totalMines = mines;
+    tilesRevealed = 0;
+    flagsPlaced = 0;
+    state = PLAYING;
+    lastPeakFrontier = 0;
+    changedCells.clear();
+
+    cells.assign(GetCellCount(), 0);
+    adjacentMines.assign(GetCellCount(), 0);
+    PlaceMines();
+    CalculateAdjacentMines();
+}
+
+void MineField::PlaceMines() {
+    TRACE_SCOPE("MineField::PlaceMines");
+    std::mt19937_64 generator(seed);
+
+    // Hand-rolled Fisher-Yates: std::shuffle's output differs between standard libraries,
+    // and a daily seed has to produce the same board for every player.
+    int cellCount = GetCellCount();
+    shuffled.resize(cellCount);
+    for (int i = 0; i < cellCount; ++i) shuffled[i] = i;
+    for (int i = cellCount - 1; i > 0; --i) {
+        std::swap(shuffled[i], shuffled[generator() % (unsigned long long)(i + 1)]);
+    }
+
+    for (int i = 0; i < totalMines && i < cellCount; ++i) {
+        cells[shuffled[i]] |= MINE;
+    }
+}
+
+void MineField::CalculateAdjacentMines() {
+    TRACE_SCOPE("MineField::CalculateAdjacentMines");
+    for (int cell = 0; cell < GetCellCount(); ++cell) {
+        if (!(cells[cell] & MINE)) continue;
+        ForEachNeighbor(cell, [this](int neighbor) { adjacentMines[neighbor]++; });
+    }
+}
+
+int MineField::RevealCell(int cell) {
+    changedCells.clear();
+    return Reveal(cell);
+}
+
+bool MineField::ToggleFlag(int cell) {
+    changedCells.clear();
+    return Flag(cell);
+}
+
+int MineField::ChordCell(int cell) {
+    changedCells.clear();
+    return Chord(cell);
+}
+
+size_t MineField::ApplyMoves(const std::vector<Move>& moves) {
+    changedCells.clear();
+    size_t applied = 0;
+    while (applied < moves.size() && state == PLAYING) {
+        const Move& move = moves[applied++];
+        if (move.kind == MOVE_REVEAL) Reveal(move.cell);
+        else if (move.kind == MOVE_FLAG) Flag(move.cell);
+        else Chord(move.cell);
+    }
+    return applied;
+}
+
+int MineField::Reveal(int cell) {
+    if (state != PLAYING || cell < 0 || cell >= GetCellCount()) return 0;
+    if (cells[cell] & (REVEALED | FLAGGED)) return 0;
+
+    int revealedBefore = tilesRevealed;
+    cells[cell] |= REVEALED;
+    tilesRevealed++;
+    changedCells.push_back(cell);
+
+    if (cells[cell] & MINE) {
+        FinishGame(LOSE);
+    } else {
+        if (adjacentMines[cell] == 0) RevealEmptyCells(cell);
+        if (tilesRevealed == GetCellCount() - totalMines) FinishGame(WIN);
+    }
+    return tilesRevealed - revealedBefore;
+}
+
+bool MineField::Flag(int cell) {
+    if (state != PLAYING || cell < 0 || cell >= GetCellCount()) return false;
+    if (cells[cell] & REVEALED) return false;
+
+    cells[cell] ^= FLAGGED;
+    flagsPlaced += (cells[cell] & FLAGGED) ? 1 : -1;
+    changedCells.push_back(cell);
+    return true;
+}
+
+int MineField::Chord(int cell) {
+    if (state != PLAYING || cell < 0 || cell >= GetCellCount()) return 0;
+    if ((cells[cell] & (REVEALED | MINE)) != REVEALED || adjacentMines[cell] == 0) return 0;
+
+    int flags = 0;
+    ForEachNeighbor(cell, [&](int neighbor) { flags += (cells[neighbor] & FLAGGED) ? 1 : 0; });
+    if (flags != adjacentMines[cell]) return 0;
+
+    int revealed = 0;
+    ForEachNeighbor(cell, [&](int neighbor) {
+        if (state == PLAYING) revealed += Reveal(neighbor);
+    });
+    return revealed;
+}
+
+// An explicit frontier instead of recursion, so huge openings cannot overflow the stack.
+void MineField::RevealEmptyCells(int start) {
+    frontier.assign(1, start);
+    lastPeakFrontier = 1;
+    while (!frontier.empty()) {
+        int current = frontier.back();
+        frontier.pop_back();
+        ForEachNeighbor(current, [this](int neighbor) {
+            if (cells[neighbor] & (REVEALED | FLAGGED | MINE)) return;
+            cells[neighbor] |= REVEALED;
+            tilesRevealed++;
+            changedCells.push_back(neighbor);
+            if (adjacentMines[neighbor] == 0) frontier.push_back(neighbor);
+        });
+        lastPeakFrontier = std::max(lastPeakFrontier, frontier.size());
+    }
+}
+
+// Losing shows every mine; winning flags them all.
+void MineField::FinishGame(GameState result) {
+    state = result;
+    changedCells.clear();
+    for (int cell = 0; cell < GetCellCount(); ++cell) {
+        if (!(cells[cell] & MINE)) continue;
+        cells[cell] |= (result == LOSE) ? REVEALED : FLAGGED;
+    }
+    if (result == WIN) flagsPlaced = totalMines;
+}
+
+// 3BV (Bechtel's Board Benchmark Value) is the fewest left clicks that clear the board:
+// one per opening (a connected patch of zero cells plus its numbered border), plus one
+// for every numbered cell that no opening reveals.
+int MineField::Calculate3BV() const {
+    std::vector<char> covered(GetCellCount(), 0);
+    std::vector<int> pending;
+    int clicks = 0;
+
+    for (int start = 0; start < GetCellCount(); ++start) {
+        if ((cells[start] & MINE) || adjacentMines[start] != 0 || covered[start]) continue;
+        clicks++;
+        covered[start] = 1;
+        pending.push_back(start);
+        while (!pending.empty()) {
+            int cell = pending.back();
+            pending.pop_back();
+            ForEachNeighbor(cell, [&](int neighbor) {
+                if (covered[neighbor] || (cells[neighbor] & MINE)) return;
+                covered[neighbor] = 1;
+                if (adjacentMines[neighbor] == 0) pending.push_back(neighbor);
+            });
+        }
+    }
+
+    for (int cell = 0; cell < GetCellCount(); ++cell) {
+        if (!(cells[cell] & MINE) && !covered[cell]) clicks++;
+    }
+    return clicks;
+}
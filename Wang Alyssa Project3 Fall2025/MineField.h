@@ -0,0 +1,103 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_MINEFIELD_H
+#define MINESWEEPER_MINEFIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The rules of the game with no rendering attached: mine placement from a seed, reveals,
+// flood fill, flags, and win/lose detection. Board draws one of these; replay verification
+// and other headless users run it directly. Cells are addressed as row * columns + column.
+class MineField {
+public:
+    enum GameState { PLAYING, WIN, LOSE };
+    enum MoveKind : uint8_t { MOVE_REVEAL, MOVE_FLAG, MOVE_CHORD };
+
+    struct Move {
+        int cell;
+        MoveKind kind;
+    };
+
+    // Reuses the existing storage, so re-initializing the same size never allocates.
+    void Initialize(int columns, int rows, int mines, unsigned long long seed);
+
+    // Left click: returns how many cells were revealed (0 if the click did nothing).
+    int RevealCell(int cell);
+    // Right click: returns false if the cell can't be flagged or unflagged.
+    bool ToggleFlag(int cell);
+    // Both buttons on a revealed number: once its flags are all placed, reveals the rest of
+    // its neighbors. Returns how many cells were revealed.
+    int ChordCell(int cell);
+    // Applies the moves in order as one action, so GetChangedCells() afterwards covers the
+    // whole batch. Stops after the move that ends the game and returns how many were applied.
+    size_t ApplyMoves(const std::vector<Move>& moves);
+
+    GameState GetState() const { return state; }
+    int GetColumns() const { return columns; }
+    int GetRows() const { return rows; }
+    int GetCellCount() const { return columns * rows; }
+    int GetTotalMines() const { return totalMines; }
+    int GetFlagsPlaced() const { return flagsPlaced; }
+    unsigned long long GetSeed() const { return seed; }
+
+    bool IsMine(int cell) const { return cells[cell] & MINE; }
+    bool IsRevealed(int cell) const { return cells[cell] & REVEALED; }
+    bool HasFlag(int cell) const { return cells[cell] & FLAGGED; }
+    int GetAdjacentMines(int cell) const { return adjacentMines[cell]; }
+
+    // Cells whose appearance changed during the last action. Empty if the whole board
+    // changed (a win or a loss), which callers treat as "redraw everything".
+    const std::vector<int>& GetChangedCells() const { return changedCells; }
+    size_t GetLastPeakFrontier() const { return lastPeakFrontier; }
+
+    int Calculate3BV() const;
+
+private:
+    static const uint8_t MINE = 1;
+    static const uint8_t REVEALED = 2;
+    static const uint8_t FLAGGED = 4;
+
+    int columns = 0;
+    int rows = 0;
+    int totalMines = 0;
+    int tilesRevealed = 0;
+    int flagsPlaced = 0;
+    unsigned long long seed = 0;
+    GameState state = PLAYING;
+
+    std::vector<uint8_t> cells;
+    std::vector<uint8_t> adjacentMines;
+    std::vector<int> shuffled;
+    std::vector<int> frontier;
+    std::vector<int> changedCells;
+    size_t lastPeakFrontier = 0;
+
+    void PlaceMines();
+    void CalculateAdjacentMines();
+    void RevealEmptyCells(int start);
+    void FinishGame(GameState result);
+    // The moves without clearing changedCells first, so a batch can collect them all.
+    int Reveal(int cell);
+    bool Flag(int cell);
+    int Chord(int cell);
+
+    // Calls visit(neighbor) for each in-bounds neighbor of cell.
+    template <typename Visit>
+    void ForEachNeighbor(int cell, Visit visit) const {
+        int row = cell / columns;
+        int column = cell - row * columns;
+        for (int r = row - 1; r <= row + 1; ++r) {
+            if (r < 0 || r >= rows) continue;
+            for (int c = column - 1; c <= column + 1; ++c) {
+                if (c < 0 || c >= columns || (r == row && c == column)) continue;
+                visit(r * columns + c);
+            }
+        }
+    }
+};
+
+#endif //MINESWEEPER_MINEFIELD_H
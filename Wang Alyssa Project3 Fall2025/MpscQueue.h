@@ -0,0 +1,56 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_MPSCQUEUE_H
+#define MINESWEEPER_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free queue for many producers and one consumer (Vyukov's linked-list
+// design). Push is a single atomic exchange and never waits; Pop never blocks and returns
+// false when the queue is empty or the newest push is still linking itself in.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node()), tail(head.load()) {}
+
+    ~MpscQueue() {
+        T value;
+        while (Pop(value)) {}
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void Push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer thread only.
+    bool Pop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        T value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+    // Producers swing head; the consumer owns tail, a dummy node whose successor is next.
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+#endif //MINESWEEPER_MPSCQUEUE_H
@@ -0,0 +1,221 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "PlayerStats.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::is_trivially_copyable<PlayerRecord>::value, "PlayerRecord is written to disk byte for byte");
+
+static const char STATS_MAGIC[4] = {'M', 'S', 'P', 'S'};
+static const uint32_t STATS_FORMAT_VERSION = 1;
+
+// Marker increments for the median: the minimum, the quartiles and the maximum.
+static const double MARKER_INCREMENTS[5] = {0.0, 0.25, 0.5, 0.75, 1.0};
+
+void MedianEstimator::Add(double value) {
+    if (count < 5) {
+        heights[count++] = value;
+        if (count == 5) {
+            std::sort(heights, heights + 5);
+            for (int i = 0; i < 5; ++i) positions[i] = i + 1;
+        }
+        return;
+    }
+
+    int cell;
+    if (value < heights[0]) {
+        heights[0] = value;
+        cell = 0;
+    } else if (value >= heights[4]) {
+        heights[4] = value;
+        cell = 3;
+    } else {
+        cell = 0;
+        while (value >= heights[cell + 1]) cell++;
+    }
+    for (int i = cell + 1; i < 5; ++i) positions[i]++;
+    count++;
+
+    for (int i = 1; i <= 3; ++i) {
+        double desired = 1.0 + (count - 1) * MARKER_INCREMENTS[i];
+        double offset = desired - positions[i];
+        if ((offset >= 1.0 && positions[i + 1] - positions[i] > 1) || (offset <= -1.0 && positions[i - 1] - positions[i] < -1)) {
+            int step = offset > 0 ? 1 : -1;
+            double below = positions[i] - positions[i - 1];
+            double above = positions[i + 1] - positions[i];
+            double parabolic = heights[i] + step / (double)(positions[i + 1] - positions[i - 1]) *
+                               ((below + step) * (heights[i + 1] - heights[i]) / above +
+                                (above - step) * (heights[i] - heights[i - 1]) / below);
+            if (heights[i - 1] < parabolic && parabolic < heights[i + 1]) {
+                heights[i] = parabolic;
+            } else {
+                heights[i] += step * (heights[i + step] - heights[i]) / (double)(positions[i + step] - positions[i]);
+            }
+            positions[i] += step;
+        }
+    }
+}
+
+double MedianEstimator::Get() const {
+    if (count == 0) return 0.0;
+    if (count >= 5) return heights[2];
+    double sorted[5];
+    std::copy(heights, heights + count, sorted);
+    std::sort(sorted, sorted + count);
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+// flock() on the stats file for the lifetime of the object.
+class StatsLock {
+public:
+    explicit StatsLock(int fd) : fd(fd) {
+        while (fd >= 0 && flock(fd, LOCK_EX) != 0 && errno == EINTR) {}
+    }
+    ~StatsLock() {
+        if (fd >= 0) flock(fd, LOCK_UN);
+    }
+    StatsLock(const StatsLock&) = delete;
+    StatsLock& operator=(const StatsLock&) = delete;
+
+private:
+    int fd;
+};
+
+static off_t RecordOffset(size_t recordIndex) {
+    return (off_t)(sizeof(uint64_t) * 2 + recordIndex * sizeof(PlayerRecord));
+}
+
+PlayerStats::~PlayerStats() {
+    if (fd >= 0) close(fd);
+}
+
+std::string PlayerStats::IndexKey(std::string_view name, int columns, int rows, int mines) {
+    std::string key(name);
+    key += '\n';
+    key += std::to_string(columns) + "x" + std::to_string(rows) + "x" + std::to_string(mines);
+    return key;
+}
+
+bool PlayerStats::Open(const std::string& statsPath) {
+    static_assert(sizeof(FileHeader) == sizeof(uint64_t) * 2, "header layout");
+    path = statsPath;
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open " << path << "!" << std::endl;
+        return false;
+    }
+
+    StatsLock lock(fd);
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size == 0) {
+        FileHeader header;
+        std::memcpy(header.magic, STATS_MAGIC, sizeof(STATS_MAGIC));
+        header.formatVersion = STATS_FORMAT_VERSION;
+        header.recordCount = 0;
+        if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            std::cerr << "Error: Could not write " << path << "!" << std::endl;
+            return false;
+        }
+    }
+    return LoadNewRecords();
+}
+
+// Reads any records appended (by us or another instance) since the last call.
+bool PlayerStats::LoadNewRecords() {
+    FileHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        std::memcmp(header.magic, STATS_MAGIC, sizeof(STATS_MAGIC)) != 0 || header.formatVersion != STATS_FORMAT_VERSION) {
+        std::cerr << "Error: " << path << " is not a player stats file!" << std::endl;
+        return false;
+    }
+    if (header.recordCount <= records.size()) return true;
+
+    size_t first = records.size();
+    records.resize(header.recordCount);
+    size_t bytes = (records.size() - first) * sizeof(PlayerRecord);
+    if (pread(fd, &records[first], bytes, RecordOffset(first)) != (ssize_t)bytes) {
+        std::cerr << "Error: Could not read " << path << "!" << std::endl;
+        records.resize(first);
+        return false;
+    }
+
+    index.reserve(records.size());
+    for (size_t i = first; i < records.size(); ++i) {
+        const PlayerRecord& record = records[i];
+        std::string_view name(record.name, strnlen(record.name, PlayerRecord::NAME_SIZE));
+        index[IndexKey(name, record.columns, record.rows, record.mines)] = (uint32_t)i;
+    }
+    return true;
+}
+
+const PlayerRecord* PlayerStats::Find(const std::string& name, const LeaderboardKey& key) const {
+    std::string_view shortName(name.data(), std::min<size_t>(name.size(), PlayerRecord::NAME_SIZE - 1));
+    auto it = index.find(IndexKey(shortName, key.columns, key.rows, key.mines));
+    return it == index.end() ? nullptr : &records[it->second];
+}
+
+// The returned pointer is valid until the next RecordGame call.
+const PlayerRecord* PlayerStats::RecordGame(const std::string& name, const LeaderboardKey& key, bool won, int seconds, int bv3) {
+    if (fd < 0) return nullptr;
+    StatsLock lock(fd);
+    if (!LoadNewRecords()) return nullptr;
+
+    std::string_view shortName(name.data(), std::min<size_t>(name.size(), PlayerRecord::NAME_SIZE - 1));
+    std::string indexKey = IndexKey(shortName, key.columns, key.rows, key.mines);
+    auto it = index.find(indexKey);
+    bool created = (it == index.end());
+    size_t recordIndex;
+    if (created) {
+        recordIndex = records.size();
+        PlayerRecord record;
+        std::memcpy(record.name, shortName.data(), shortName.size());
+        record.columns = key.columns;
+        record.rows = key.rows;
+        record.mines = key.mines;
+        records.push_back(record);
+        index.emplace(std::move(indexKey), (uint32_t)recordIndex);
+    } else {
+        // Another instance may have updated this player since we loaded it.
+        recordIndex = it->second;
+        if (pread(fd, &records[recordIndex], sizeof(PlayerRecord), RecordOffset(recordIndex)) != (ssize_t)sizeof(PlayerRecord)) {
+            std::cerr << "Error: Could not read " << path << "!" << std::endl;
+        }
+    }
+
+    PlayerRecord& record = records[recordIndex];
+    record.gamesPlayed++;
+    if (won) {
+        record.wins++;
+        record.currentStreak++;
+        record.bestStreak = std::max(record.bestStreak, record.currentStreak);
+        if (record.bestSeconds < 0 || seconds < record.bestSeconds) record.bestSeconds = seconds;
+        record.total3BV += (uint64_t)bv3;
+        record.totalWinSeconds += (uint64_t)std::max(seconds, 1);
+        record.medianSeconds.Add(seconds);
+    } else {
+        record.losses++;
+        record.currentStreak = 0;
+    }
+
+    if (pwrite(fd, &record, sizeof(PlayerRecord), RecordOffset(recordIndex)) != (ssize_t)sizeof(PlayerRecord)) {
+        std::cerr << "Error: Could not write " << path << "!" << std::endl;
+        return &record;
+    }
+    if (created) {
+        uint64_t recordCount = records.size();
+        if (pwrite(fd, &recordCount, sizeof(recordCount), offsetof(FileHeader, recordCount)) != (ssize_t)sizeof(recordCount)) {
+            std::cerr << "Error: Could not write " << path << "!" << std::endl;
+        }
+    }
+    return &record;
+}
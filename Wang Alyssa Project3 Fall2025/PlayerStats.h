@@ -0,0 +1,80 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_PLAYERSTATS_H
+#define MINESWEEPER_PLAYERSTATS_H
+
+#include "Leaderboard.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Streaming median (the P-squared algorithm of Jain and Chlamtac): five markers track the
+// minimum, quartiles, median and maximum, so the estimate needs no stored samples.
+struct MedianEstimator {
+    double heights[5] = {};
+    int32_t positions[5] = {};
+    uint32_t count = 0;
+
+    void Add(double value);
+    double Get() const;
+};
+
+// One fixed-size record per (player, board configuration). The file is a small header
+// followed by these records, so a record can be rewritten in place at a known offset.
+struct PlayerRecord {
+    static const int NAME_SIZE = 16;
+
+    char name[NAME_SIZE] = {};
+    int32_t columns = 0;
+    int32_t rows = 0;
+    int32_t mines = 0;
+    uint32_t gamesPlayed = 0;
+    uint32_t wins = 0;
+    uint32_t losses = 0;
+    uint32_t currentStreak = 0;
+    uint32_t bestStreak = 0;
+    int32_t bestSeconds = -1;
+    uint32_t reserved = 0;
+    uint64_t total3BV = 0;
+    uint64_t totalWinSeconds = 0;
+    MedianEstimator medianSeconds;
+
+    // Board Benchmark Value cleared per second, over all wins.
+    double Get3BVPerSecond() const { return totalWinSeconds ? (double)total3BV / (double)totalWinSeconds : 0.0; }
+};
+
+// Per-player aggregates in a compact binary file, indexed in memory by name and
+// configuration. Every update is one hash lookup plus one positioned write; other game
+// instances are picked up under an advisory lock before each write.
+class PlayerStats {
+public:
+    PlayerStats() = default;
+    ~PlayerStats();
+    PlayerStats(const PlayerStats&) = delete;
+    PlayerStats& operator=(const PlayerStats&) = delete;
+
+    bool Open(const std::string& path);
+    const PlayerRecord* RecordGame(const std::string& name, const LeaderboardKey& key, bool won, int seconds, int bv3);
+    const PlayerRecord* Find(const std::string& name, const LeaderboardKey& key) const;
+    size_t GetRecordCount() const { return records.size(); }
+
+private:
+    struct FileHeader {
+        char magic[4];
+        uint32_t formatVersion;
+        uint64_t recordCount;
+    };
+
+    int fd = -1;
+    std::string path;
+    std::vector<PlayerRecord> records;
+    std::unordered_map<std::string, uint32_t> index;
+
+    static std::string IndexKey(std::string_view name, int columns, int rows, int mines);
+    bool LoadNewRecords();
+};
+
+#endif //MINESWEEPER_PLAYERSTATS_H
@@ -0,0 +1,157 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "RankTree.h"
+
+void RankTree::Clear() {
+    nodes.clear();
+    root = NONE;
+}
+
+void RankTree::Reserve(size_t count) {
+    nodes.reserve(count);
+}
+
+bool RankTree::Less(int a, int b) const {
+    if (nodes[a].totalSeconds != nodes[b].totalSeconds) return nodes[a].totalSeconds < nodes[b].totalSeconds;
+    return a < b;
+}
+
+void RankTree::Update(int node) {
+    nodes[node].size = SizeOf(nodes[node].left) + SizeOf(nodes[node].right) + 1;
+}
+
+int RankTree::RotateLeft(int node) {
+    int child = nodes[node].right;
+    nodes[node].right = nodes[child].left;
+    nodes[child].left = node;
+    Update(node);
+    Update(child);
+    return child;
+}
+
+int RankTree::RotateRight(int node) {
+    int child = nodes[node].left;
+    nodes[node].left = nodes[child].right;
+    nodes[child].right = node;
+    Update(node);
+    Update(child);
+    return child;
+}
+
+// xorshift64*: the priorities only need to be well spread, not unpredictable.
+unsigned int RankTree::NextPriority() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return (unsigned int)((randomState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+size_t RankTree::Insert(int totalSeconds) {
+    int index = (int)nodes.size();
+    Node node;
+    node.totalSeconds = totalSeconds;
+    node.priority = NextPriority();
+    nodes.push_back(node);
+
+    size_t rank = 0;
+    root = InsertAt(root, index, rank);
+    return rank;
+}
+
+// Every node passed on the way down to the right is smaller than the new entry, so the
+// rank falls out of the descent. Rotations afterwards don't change it.
+int RankTree::InsertAt(int node, int index, size_t& rank) {
+    if (node == NONE) return index;
+
+    if (Less(index, node)) {
+        nodes[node].left = InsertAt(nodes[node].left, index, rank);
+        if (nodes[nodes[node].left].priority > nodes[node].priority) return RotateRight(node);
+    } else {
+        rank += SizeOf(nodes[node].left) + 1;
+        nodes[node].right = InsertAt(nodes[node].right, index, rank);
+        if (nodes[nodes[node].right].priority > nodes[node].priority) return RotateLeft(node);
+    }
+    Update(node);
+    return node;
+}
+
+size_t RankTree::Rank(int index) const {
+    size_t rank = 0;
+    int node = root;
+    while (node != NONE) {
+        if (node == index) return rank + SizeOf(nodes[node].left);
+        if (Less(index, node)) {
+            node = nodes[node].left;
+        } else {
+            rank += SizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+    }
+    return rank;
+}
+
+size_t RankTree::LowerBound(int totalSeconds) const {
+    size_t rank = 0;
+    int node = root;
+    while (node != NONE) {
+        if (nodes[node].totalSeconds >= totalSeconds) {
+            node = nodes[node].left;
+        } else {
+            rank += SizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+    }
+    return rank;
+}
+
+int RankTree::Select(size_t rank) const {
+    int node = root;
+    while (node != NONE) {
+        size_t leftSize = SizeOf(nodes[node].left);
+        if (rank < leftSize) {
+            node = nodes[node].left;
+        } else if (rank == leftSize) {
+            return node;
+        } else {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+    return NONE;
+}
+
+// Walks down to firstRank keeping the ancestors still to be visited on a stack, then
+// continues as an ordinary in-order traversal.
+void RankTree::Range(size_t firstRank, size_t count, std::vector<int>& indices) const {
+    if (firstRank >= nodes.size() || count == 0) return;
+
+    std::vector<int> stack;
+    int node = root;
+    size_t rank = firstRank;
+    while (node != NONE) {
+        size_t leftSize = SizeOf(nodes[node].left);
+        if (rank < leftSize) {
+            stack.push_back(node);
+            node = nodes[node].left;
+        } else if (rank == leftSize) {
+            stack.push_back(node);
+            break;
+        } else {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+
+    while (!stack.empty() && count > 0) {
+        node = stack.back();
+        stack.pop_back();
+        indices.push_back(node);
+        count--;
+
+        for (int child = nodes[node].right; child != NONE; child = nodes[child].left) {
+            stack.push_back(child);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_RANKTREE_H
+#define MINESWEEPER_RANKTREE_H
+
+#include <cstddef>
+#include <vector>
+
+// Order-statistic treap over finishing times. Every node also knows the size of its subtree,
+// so insert, rank, select and "ranks i..i+k" are all O(log n) (plus k for ranges).
+// Entries are identified by insertion index, which doubles as the tiebreaker: equal times
+// rank in the order they were submitted. Nodes live in one vector, indexed by that same id.
+class RankTree {
+public:
+    static const int NONE = -1;
+
+    void Clear();
+    void Reserve(size_t count);
+
+    // Inserts entry number Size() and returns its 0-based rank.
+    size_t Insert(int totalSeconds);
+    size_t Size() const { return nodes.size(); }
+    int GetSeconds(int index) const { return nodes[index].totalSeconds; }
+
+    size_t Rank(int index) const;
+    // Rank of the first entry whose time is >= totalSeconds.
+    size_t LowerBound(int totalSeconds) const;
+    int Select(size_t rank) const;
+    // Appends the indices ranked firstRank .. firstRank + count - 1, best first.
+    void Range(size_t firstRank, size_t count, std::vector<int>& indices) const;
+
+private:
+    struct Node {
+        int totalSeconds = 0;
+        unsigned int priority = 0;
+        int left = NONE;
+        int right = NONE;
+        unsigned int size = 1;
+    };
+
+    std::vector<Node> nodes;
+    int root = NONE;
+    unsigned long long randomState = 0x9E3779B97F4A7C15ULL;
+
+    bool Less(int a, int b) const;
+    unsigned int SizeOf(int node) const { return node == NONE ? 0 : nodes[node].size; }
+    void Update(int node);
+    int RotateLeft(int node);
+    int RotateRight(int node);
+    int InsertAt(int node, int index, size_t& rank);
+    unsigned int NextPriority();
+};
+
+#endif //MINESWEEPER_RANKTREE_H
@@ -0,0 +1,124 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// RankTreeBenchmark [entries]
+// Checks RankTree against a sorted vector on random inserts, then times inserts, ranks and
+// ranges on a tree of the given size (10,000,000 by default, the scale a long-running
+// shared leaderboard reaches). Exits with 1 if the tree disagrees with the model.
+
+#include "RankTree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const int MODEL_ENTRIES = 20000;
+static const int MAX_SECONDS = 99 * 60 + 59;
+static const int QUERIES = 1000000;
+static const int RANGE_LENGTH = 20;
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The model is the (time, insertion index) pairs in rank order, kept sorted by brute force.
+static bool MatchesModel() {
+    std::mt19937 random(41);
+    std::uniform_int_distribution<int> seconds(0, MAX_SECONDS);
+    RankTree tree;
+    std::vector<std::pair<int, int>> model;
+    std::vector<int> range;
+
+    for (int index = 0; index < MODEL_ENTRIES; ++index) {
+        int totalSeconds = seconds(random);
+        std::pair<int, int> entry(totalSeconds, index);
+        auto position = std::lower_bound(model.begin(), model.end(), entry);
+        size_t expectedRank = position - model.begin();
+        model.insert(position, entry);
+
+        if (tree.Insert(totalSeconds) != expectedRank) {
+            std::fprintf(stderr, "Error: Insert %d returned the wrong rank!\n", index);
+            return false;
+        }
+        // A full check of every entry each time would be quadratic, so sample a few.
+        for (int probe = 0; probe < 4; ++probe) {
+            size_t rank = std::uniform_int_distribution<size_t>(0, model.size() - 1)(random);
+            int other = model[rank].second;
+            if (tree.Select(rank) != other || tree.Rank(other) != rank) {
+                std::fprintf(stderr, "Error: Select/Rank disagree at rank %zu!\n", rank);
+                return false;
+            }
+            int bound = seconds(random);
+            size_t expectedBound = std::lower_bound(model.begin(), model.end(), std::make_pair(bound, -1)) - model.begin();
+            if (tree.LowerBound(bound) != expectedBound) {
+                std::fprintf(stderr, "Error: LowerBound(%d) is wrong!\n", bound);
+                return false;
+            }
+            range.clear();
+            tree.Range(rank, RANGE_LENGTH, range);
+            size_t expectedLength = std::min<size_t>(RANGE_LENGTH, model.size() - rank);
+            if (range.size() != expectedLength) {
+                std::fprintf(stderr, "Error: Range at rank %zu has the wrong length!\n", rank);
+                return false;
+            }
+            for (size_t i = 0; i < range.size(); ++i) {
+                if (range[i] != model[rank + i].second) {
+                    std::fprintf(stderr, "Error: Range at rank %zu is out of order!\n", rank);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    if (entries == 0) {
+        std::fprintf(stderr, "Error: The entry count must be positive!\n");
+        return 1;
+    }
+
+    if (!MatchesModel()) return 1;
+    std::printf("model check: %d random inserts match\n", MODEL_ENTRIES);
+
+    std::mt19937 random(43);
+    std::uniform_int_distribution<int> seconds(0, MAX_SECONDS);
+    RankTree tree;
+    tree.Reserve(entries + QUERIES);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; ++i) tree.Insert(seconds(random));
+    double buildSeconds = SecondsSince(start);
+    std::printf("build:  %zu inserts in %.2f s, %.2f us/op\n", entries, buildSeconds, buildSeconds * 1e6 / entries);
+
+    // Every query result feeds the checksum so none of them can be optimized away.
+    std::uniform_int_distribution<size_t> ranks(0, entries - 1);
+    unsigned long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < QUERIES; ++i) checksum += tree.Rank((int)ranks(random));
+    double rankSeconds = SecondsSince(start);
+
+    std::vector<int> range;
+    range.reserve(RANGE_LENGTH);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < QUERIES; ++i) {
+        range.clear();
+        tree.Range(ranks(random), RANGE_LENGTH, range);
+        checksum += range.size();
+    }
+    double rangeSeconds = SecondsSince(start);
+
+    // Inserts at full size, into the room reserved for them above.
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < QUERIES; ++i) checksum += tree.Insert(seconds(random));
+    double insertSeconds = SecondsSince(start);
+
+    std::printf("rank:   %.2f us/op\n", rankSeconds * 1e6 / QUERIES);
+    std::printf("range:  %.2f us/op for %d entries\n", rangeSeconds * 1e6 / QUERIES, RANGE_LENGTH);
+    std::printf("insert: %.2f us/op at %zu entries\n", insertSeconds * 1e6 / QUERIES, entries);
+    std::printf("checksum %llu\n", checksum);
+    return 0;
+}
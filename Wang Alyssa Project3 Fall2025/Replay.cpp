@@ -0,0 +1,115 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "Replay.h"
+#include <algorithm>
+
+// The in-game clock stops at 99:59.
+static const int MAX_CLOCK_SECONDS = 99 * 60 + 59;
+
+void GameReplay::Reset(int columns, int rows, int mines, unsigned long long seed) {
+    this->columns = columns;
+    this->rows = rows;
+    this->mines = mines;
+    this->seed = seed;
+    moves.clear();
+}
+
+void GameReplay::Record(uint32_t timeMillis, int cell, ReplayAction action) {
+    moves.push_back({timeMillis, cell, action});
+}
+
+const char* DescribeVerdict(ReplayVerdict verdict) {
+    switch (verdict) {
+        case REPLAY_ACCEPTED: return "accepted";
+        case REPLAY_BAD_BOARD: return "invalid board";
+        case REPLAY_BAD_MOVE: return "invalid move";
+        case REPLAY_TIME_REVERSED: return "moves out of order";
+        case REPLAY_TOO_FAST: return "moves too fast";
+        case REPLAY_MOVE_AFTER_END: return "moves after the game ended";
+        case REPLAY_NOT_WON: return "game not won";
+        case REPLAY_TIME_MISMATCH: return "time does not match";
+    }
+    return "unknown";
+}
+
+ReplayVerdict ReplayVerifier::Verify(const GameReplay& replay, int claimedSeconds, MineField& scratch) {
+    long long cellCount = (long long)replay.columns * replay.rows;
+    if (replay.columns <= 0 || replay.rows <= 0 || cellCount > MAX_CELLS || replay.mines < 0 || replay.mines >= cellCount) {
+        return REPLAY_BAD_BOARD;
+    }
+    scratch.Initialize(replay.columns, replay.rows, replay.mines, replay.seed);
+
+    const std::vector<ReplayMove>& moves = replay.moves;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const ReplayMove& move = moves[i];
+        if (move.cell < 0 || move.cell >= cellCount || move.action > REPLAY_FLAG) return REPLAY_BAD_MOVE;
+        if (i > 0 && move.timeMillis < moves[i - 1].timeMillis) return REPLAY_TIME_REVERSED;
+        if (i >= (size_t)MAX_MOVES_PER_SECOND && move.timeMillis - moves[i - MAX_MOVES_PER_SECOND].timeMillis < 1000) {
+            return REPLAY_TOO_FAST;
+        }
+        if (scratch.GetState() != MineField::PLAYING) return REPLAY_MOVE_AFTER_END;
+
+        // Clicks that change nothing (a revealed cell, a flagged one) happen in real games too.
+        if (move.action == REPLAY_REVEAL) {
+            scratch.RevealCell(move.cell);
+        } else {
+            scratch.ToggleFlag(move.cell);
+        }
+    }
+    if (scratch.GetState() != MineField::WIN) return REPLAY_NOT_WON;
+
+    // The game stops its clock at the time of the winning click, so the claim must match it.
+    int winSeconds = std::min<int>(moves.back().timeMillis / 1000, MAX_CLOCK_SECONDS);
+    if (claimedSeconds != winSeconds) return REPLAY_TIME_MISMATCH;
+    return REPLAY_ACCEPTED;
+}
+
+ReplayVerifier::~ReplayVerifier() {
+    Stop();
+}
+
+void ReplayVerifier::Start(unsigned int threadCount) {
+    Stop();
+    stopping = false;
+    for (unsigned int i = 0; i < std::max(1u, threadCount); ++i) {
+        workers.emplace_back(&ReplayVerifier::Run, this);
+    }
+}
+
+void ReplayVerifier::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+}
+
+void ReplayVerifier::Submit(GameReplay replay, int claimedSeconds, CompletionFunction onComplete) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({std::move(replay), claimedSeconds, std::move(onComplete)});
+    }
+    wakeup.notify_one();
+}
+
+void ReplayVerifier::Run() {
+    MineField scratch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeup.wait(lock, [this]() { return stopping || !jobs.empty(); });
+        if (jobs.empty()) break;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+
+        ReplayVerdict verdict = Verify(job.replay, job.claimedSeconds, scratch);
+        if (job.onComplete) job.onComplete(verdict);
+
+        lock.lock();
+    }
+}
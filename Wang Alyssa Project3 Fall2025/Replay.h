@@ -0,0 +1,86 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_REPLAY_H
+#define MINESWEEPER_REPLAY_H
+
+#include "MineField.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum ReplayAction : uint8_t { REPLAY_REVEAL, REPLAY_FLAG };
+
+struct ReplayMove {
+    uint32_t timeMillis;
+    int32_t cell;
+    uint8_t action;
+};
+
+// Everything needed to play a game again: the board it was played on and every click on
+// it, timed in game milliseconds (pauses excluded).
+struct GameReplay {
+    int columns = 0;
+    int rows = 0;
+    int mines = 0;
+    unsigned long long seed = 0;
+    std::vector<ReplayMove> moves;
+
+    void Reset(int columns, int rows, int mines, unsigned long long seed);
+    void Record(uint32_t timeMillis, int cell, ReplayAction action);
+};
+
+enum ReplayVerdict {
+    REPLAY_ACCEPTED,
+    REPLAY_BAD_BOARD,
+    REPLAY_BAD_MOVE,
+    REPLAY_TIME_REVERSED,
+    REPLAY_TOO_FAST,
+    REPLAY_MOVE_AFTER_END,
+    REPLAY_NOT_WON,
+    REPLAY_TIME_MISMATCH
+};
+
+const char* DescribeVerdict(ReplayVerdict verdict);
+
+// Re-executes submitted games on a pool of worker threads before their scores are accepted.
+// Completion callbacks run on the worker thread that checked the replay.
+class ReplayVerifier {
+public:
+    using CompletionFunction = std::function<void(ReplayVerdict)>;
+
+    // No human clicks faster than this for a whole second.
+    static const int MAX_MOVES_PER_SECOND = 30;
+    static const int MAX_CELLS = 1 << 26;
+
+    ~ReplayVerifier();
+    void Start(unsigned int threadCount);
+    // Finishes the queued replays before the workers exit.
+    void Stop();
+    void Submit(GameReplay replay, int claimedSeconds, CompletionFunction onComplete);
+
+    // Plays the game on scratch, which is reused between calls so verifying doesn't allocate.
+    static ReplayVerdict Verify(const GameReplay& replay, int claimedSeconds, MineField& scratch);
+
+private:
+    struct Job {
+        GameReplay replay;
+        int claimedSeconds;
+        CompletionFunction onComplete;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+    std::deque<Job> jobs;
+
+    void Run();
+};
+
+#endif //MINESWEEPER_REPLAY_H
@@ -0,0 +1,50 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+// MinesweeperServer [--listen <address>] [--shards <count>]
+// Hosts headless games over the binary protocol in ServerProtocol.h until SIGINT/SIGTERM.
+// The address is "unix:<path>" or a TCP port on 127.0.0.1 (default 7878); there is one
+// shard thread per core unless --shards says otherwise.
+
+#include "GameServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static GameServer* runningServer = nullptr;
+
+static void HandleSignal(int) {
+    if (runningServer) runningServer->Stop();
+}
+
+int main(int argc, char* argv[]) {
+    std::string address = "7878";
+    unsigned int shardCount = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) break;
+        else if (arg == "--listen") address = argv[++i];
+        else if (arg == "--shards") shardCount = (unsigned int)std::atoi(argv[++i]);
+    }
+
+    GameServer server;
+    if (!server.Listen(address, shardCount)) return 1;
+    runningServer = &server;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    std::cout << "Listening on " << address << std::endl;
+    server.Run();
+    runningServer = nullptr;
+    const CompletionHistogram& movesPerGame = server.GetMovesPerGame();
+    std::cout << server.GetGamesStarted() << " games, " << server.GetMovesHandled() << " moves, "
+              << server.GetGamesWon() << " won, " << server.GetGamesLost() << " lost" << std::endl;
+    std::cout << "Moves per finished game: p50 " << movesPerGame.GetPercentile(50) << "  p90 " << movesPerGame.GetPercentile(90)
+              << "  p99 " << movesPerGame.GetPercentile(99) << std::endl;
+    std::cout << "Moves per shard:";
+    for (unsigned long long moves : server.GetMovesPerShard()) std::cout << " " << moves;
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,153 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "ServerProtocol.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+size_t BeginMessage(std::vector<uint8_t>& out, MessageType type, uint32_t session) {
+    size_t start = out.size();
+    PutU32(out, 0);
+    PutU8(out, type);
+    PutU32(out, session);
+    return start;
+}
+
+void EndMessage(std::vector<uint8_t>& out, size_t start) {
+    uint32_t length = (uint32_t)(out.size() - start - FRAME_HEADER_BYTES);
+    for (size_t i = 0; i < FRAME_HEADER_BYTES; ++i) out[start + i] = (uint8_t)(length >> (8 * i));
+}
+
+void PutU8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void PutU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+void PutU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+uint32_t DeclaredPayloadLength(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+size_t CompleteFrameSize(const uint8_t* data, size_t size) {
+    if (size < FRAME_HEADER_BYTES) return 0;
+    uint32_t length = DeclaredPayloadLength(data);
+    if (size - FRAME_HEADER_BYTES < length) return 0;
+    return FRAME_HEADER_BYTES + length;
+}
+
+uint64_t MessageReader::GetLittleEndian(size_t bytes) {
+    if (!valid || size - position < bytes) {
+        valid = false;
+        return 0;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= (uint64_t)data[position + i] << (8 * i);
+    position += bytes;
+    return value;
+}
+
+uint8_t MessageReader::GetU8() { return (uint8_t)GetLittleEndian(1); }
+uint16_t MessageReader::GetU16() { return (uint16_t)GetLittleEndian(2); }
+uint32_t MessageReader::GetU32() { return (uint32_t)GetLittleEndian(4); }
+uint64_t MessageReader::GetU64() { return GetLittleEndian(8); }
+
+const uint8_t* MessageReader::GetBytes(size_t count) {
+    if (!valid || size - position < count) {
+        valid = false;
+        return nullptr;
+    }
+    const uint8_t* bytes = data + position;
+    position += count;
+    return bytes;
+}
+
+// Fills in a socket address for "unix:<path>" or a localhost TCP port.
+static bool ResolveAddress(const std::string& address, sockaddr_storage& storage, socklen_t& length) {
+    std::memset(&storage, 0, sizeof(storage));
+    if (address.rfind("unix:", 0) == 0) {
+        std::string path = address.substr(5);
+        auto* unixAddress = (sockaddr_un*)&storage;
+        if (path.empty() || path.size() >= sizeof(unixAddress->sun_path)) {
+            std::cerr << "Error: Invalid socket path " << path << "!" << std::endl;
+            return false;
+        }
+        unixAddress->sun_family = AF_UNIX;
+        std::memcpy(unixAddress->sun_path, path.c_str(), path.size() + 1);
+        length = sizeof(sockaddr_un);
+        return true;
+    }
+
+    int port = 0;
+    auto [end, ec] = std::from_chars(address.data(), address.data() + address.size(), port);
+    if (ec != std::errc() || end != address.data() + address.size() || port <= 0 || port > 65535) {
+        std::cerr << "Error: Invalid server address " << address << "!" << std::endl;
+        return false;
+    }
+    auto* inetAddress = (sockaddr_in*)&storage;
+    inetAddress->sin_family = AF_INET;
+    inetAddress->sin_port = htons((uint16_t)port);
+    inetAddress->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    length = sizeof(sockaddr_in);
+    return true;
+}
+
+int ListenOn(const std::string& address) {
+    sockaddr_storage storage;
+    socklen_t length;
+    if (!ResolveAddress(address, storage, length)) return -1;
+
+    int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Error: Could not create a socket: " << std::strerror(errno) << "!" << std::endl;
+        return -1;
+    }
+    if (storage.ss_family == AF_UNIX) {
+        unlink(((sockaddr_un*)&storage)->sun_path);
+    } else {
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+    if (bind(fd, (sockaddr*)&storage, length) != 0 || listen(fd, SOMAXCONN) != 0) {
+        std::cerr << "Error: Could not listen on " << address << ": " << std::strerror(errno) << "!" << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int ConnectTo(const std::string& address) {
+    sockaddr_storage storage;
+    socklen_t length;
+    if (!ResolveAddress(address, storage, length)) return -1;
+
+    int fd = socket(storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&storage, length) != 0) {
+        std::cerr << "Error: Could not connect to " << address << ": " << std::strerror(errno) << "!" << std::endl;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (storage.ss_family == AF_INET) {
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+    return fd;
+}
@@ -0,0 +1,131 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_SERVERPROTOCOL_H
+#define MINESWEEPER_SERVERPROTOCOL_H
+
+#include "StateStream.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wire format shared by the game server and its clients. Every message is a frame: a u32
+// payload length, then the payload, which starts with a MessageType and the u32 session id.
+// All integers are little-endian.
+//
+//   NEW_GAME    session (0 = new), u16 columns, u16 rows, u32 mines, u64 seed (0 = random)
+//   REVEAL      session, u32 cell
+//   FLAG        session, u32 cell
+//   GET_STATE   session
+//   END_GAME    session
+//   SPECTATE    session
+//   UNSPECTATE  session
+//   MOVES       session, u16 count, then per move: u8 MineField::MoveKind, u32 cell
+//
+//   GAME_STARTED  session, u64 seed, the new game's StateStream keyframe
+//   MOVE_RESULT   session, u8 state, u32 cells changed, then the move's StateStream frame
+//   STATE         session, u8 state, u16 columns, u16 rows, u32 mines, u32 flags, u8 CellCode[]
+//   GAME_ENDED    session
+//   ERROR         session, u8 ServerError
+//   STREAM        session, one StateStream frame
+//   MOVES_RESULT  session, u8 state, u16 moves applied, then the batch's StateStream frame
+//
+// MOVES applies up to MAX_BATCH_MOVES reveals, flags and chords as one action, stopping after
+// the move that ends the game, so a bot pays for one request, one reply and one stream frame
+// per batch. A batch with any out-of-range move is rejected whole.
+//
+// The owner of a session sees its board the way a spectator does, without asking for it:
+// GAME_STARTED carries a keyframe, and every result carries the frame for what that action
+// changed (a delta, or a keyframe once the game is won or lost), with nothing after the
+// fixed fields if it changed nothing. Fed to one StateStreamReader in reply order, they keep
+// it in step with the game; GET_STATE is only needed to start over.
+//
+// Any connection may SPECTATE any session, including one owned by another connection. It
+// then gets a keyframe followed by a STREAM message for every action that changes the
+// board, and GAME_ENDED when the session goes away. Stream messages arrive whenever the
+// game moves, interleaved with the replies to the spectator's own requests; a spectator
+// that falls too far behind has frames dropped and resyncs at the next keyframe.
+//
+// Sessions are sharded by id: each one runs on server thread id % thread count, and the
+// sessions a connection starts are dealt round all the threads, so one connection running
+// many games uses every core. Requests for a session on another thread take a hop there
+// and back, which costs latency but never reorders replies.
+enum MessageType : uint8_t {
+    MSG_NEW_GAME = 1,
+    MSG_REVEAL,
+    MSG_FLAG,
+    MSG_GET_STATE,
+    MSG_END_GAME,
+    MSG_SPECTATE,
+    MSG_UNSPECTATE,
+    MSG_MOVES,
+
+    MSG_GAME_STARTED = 0x81,
+    MSG_MOVE_RESULT,
+    MSG_STATE,
+    MSG_GAME_ENDED,
+    MSG_ERROR,
+    MSG_STREAM,
+    MSG_MOVES_RESULT
+};
+
+enum ServerError : uint8_t {
+    ERROR_MALFORMED = 1,
+    ERROR_NO_SESSION,
+    ERROR_BAD_BOARD,
+    ERROR_TOO_MANY_SESSIONS
+};
+
+static const size_t FRAME_HEADER_BYTES = 4;
+static const size_t MAX_BATCH_MOVES = 512;
+// Requests are a few dozen bytes, or a few kilobytes for a full batch of moves; anything
+// bigger is a broken or hostile client.
+static const size_t MAX_REQUEST_BYTES = 4096;
+
+// Appending a message: BeginMessage reserves the length, EndMessage fills it in.
+size_t BeginMessage(std::vector<uint8_t>& out, MessageType type, uint32_t session);
+void EndMessage(std::vector<uint8_t>& out, size_t start);
+void PutU8(std::vector<uint8_t>& out, uint8_t value);
+void PutU16(std::vector<uint8_t>& out, uint16_t value);
+void PutU32(std::vector<uint8_t>& out, uint32_t value);
+void PutU64(std::vector<uint8_t>& out, uint64_t value);
+
+// The length field of the frame header at data, which must hold FRAME_HEADER_BYTES.
+uint32_t DeclaredPayloadLength(const uint8_t* data);
+// Total size of the frame at the start of data, header included, or 0 if it hasn't all
+// arrived yet.
+size_t CompleteFrameSize(const uint8_t* data, size_t size);
+
+// Reads fields from one payload in order. Reading past the end yields zeros and marks the
+// message invalid, so handlers can read everything and check once.
+class MessageReader {
+public:
+    MessageReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    uint8_t GetU8();
+    uint16_t GetU16();
+    uint32_t GetU32();
+    uint64_t GetU64();
+    const uint8_t* GetBytes(size_t count);
+
+    bool IsValid() const { return valid; }
+    size_t GetRemaining() const { return size - position; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    bool valid = true;
+
+    uint64_t GetLittleEndian(size_t bytes);
+};
+
+// Addresses are "unix:<path>" or a TCP port, which is always bound to 127.0.0.1.
+// ListenOn returns a non-blocking socket and ConnectTo a blocking one, or -1 after
+// printing why.
+int ListenOn(const std::string& address);
+int ConnectTo(const std::string& address);
+
+#endif //MINESWEEPER_SERVERPROTOCOL_H
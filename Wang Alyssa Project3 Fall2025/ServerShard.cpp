@@ -0,0 +1,674 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "ServerShard.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const int MAX_EVENTS = 256;
+static const size_t READ_CHUNK = 64 * 1024;
+// A client that stops reading its replies stops getting its requests read too, and a
+// spectator that falls this far behind has stream frames dropped until it catches up.
+static const size_t MAX_PENDING_OUTPUT = 4 * 1024 * 1024;
+
+ServerShard::ServerShard(unsigned int index, unsigned int shardCount, MpscQueue<GameResult>& results)
+    : index(index), shardCount(shardCount), results(results), nextSessionId(index + shardCount),
+      outgoingRequests(shardCount), outgoingReplies(shardCount) {}
+
+// The other shards may already be gone, so closing connections here tells nobody.
+ServerShard::~ServerShard() {
+    Join();
+    peers.clear();
+    while (!connections.empty()) Close(connections.begin()->second);
+    ShardMessage message;
+    while (inbox.Pop(message)) {
+        if (message.kind == ShardMessage::ADOPT) close(message.fd);
+    }
+    if (epollFd >= 0) close(epollFd);
+    if (inboxFd >= 0) close(inboxFd);
+}
+
+void ServerShard::SetPeers(const std::vector<ServerShard*>& peers) {
+    this->peers = peers;
+}
+
+bool ServerShard::Start(int wakeFd) {
+    this->wakeFd = wakeFd;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    inboxFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || inboxFd < 0) {
+        std::cerr << "Error: Could not set up epoll: " << std::strerror(errno) << "!" << std::endl;
+        return false;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = inboxFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, inboxFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    thread = std::thread(&ServerShard::Run, this);
+    return true;
+}
+
+void ServerShard::Join() {
+    if (thread.joinable()) thread.join();
+}
+
+void ServerShard::Post(ShardMessage message) {
+    inbox.Push(std::move(message));
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(inboxFd, &one, sizeof(one));
+}
+
+void ServerShard::Run() {
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: epoll_wait failed: " << std::strerror(errno) << "!" << std::endl;
+            return;
+        }
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            // The stop eventfd is never read, so it stays readable and wakes every shard.
+            if (fd == wakeFd) return;
+            if (fd == inboxFd) {
+                ProcessInbox();
+                continue;
+            }
+
+            auto found = connections.find(fd);
+            if (found == connections.end()) continue;
+            Connection& connection = found->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                Close(connection);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !WriteTo(connection)) continue;
+            if ((events[i].events & EPOLLIN) && !ReadFrom(connection)) continue;
+            UpdateEvents(connection);
+        }
+        PostForwarded();
+        FlushPending();
+    }
+}
+
+void ServerShard::ProcessInbox() {
+    uint64_t count;
+    [[maybe_unused]] ssize_t drained = read(inboxFd, &count, sizeof(count));
+    ShardMessage message;
+    while (inbox.Pop(message)) {
+        ConnectionRef connection = {message.shard, message.fd, message.serial};
+        switch (message.kind) {
+            case ShardMessage::ADOPT: AddConnection(message.fd); break;
+            case ShardMessage::SPECTATE: AddSpectator(message.session, connection); break;
+            case ShardMessage::UNSPECTATE: RemoveSpectator(message.session, connection); break;
+            case ShardMessage::DELIVER: DeliverLocal(message.fd, message.serial, *message.frames); break;
+            case ShardMessage::REQUESTS: HandleRequests(*message.frames, message.shard); break;
+            case ShardMessage::REPLIES: HandleReplies(*message.frames); break;
+            case ShardMessage::END_SESSION: EndSessionOf(connection, message.session); break;
+        }
+    }
+}
+
+void ServerShard::AddConnection(int fd) {
+    Connection& connection = connections[fd];
+    connection.fd = fd;
+    connection.serial = nextSerial++;
+    // A connection's first session stays on its own shard.
+    connection.nextOwner = index;
+    connection.events = EPOLLIN;
+    epoll_event event = {};
+    event.events = connection.events;
+    event.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+}
+
+// A failed write closes its connection, which can end sessions and queue GAME_ENDED for
+// more spectators, so keep going until nothing new turns up.
+void ServerShard::FlushPending() {
+    std::vector<int> batch;
+    while (!flushPending.empty()) {
+        batch.swap(flushPending);
+        for (int fd : batch) {
+            auto found = connections.find(fd);
+            if (found != connections.end() && WriteTo(found->second)) UpdateEvents(found->second);
+        }
+        batch.clear();
+    }
+}
+
+// Reads whatever has arrived, handles every complete request, then tries to send the replies
+// straight away so a request/reply round trip costs one wakeup.
+bool ServerShard::ReadFrom(Connection& connection) {
+    while (true) {
+        size_t used = connection.input.size();
+        connection.input.resize(used + READ_CHUNK);
+        ssize_t received = read(connection.fd, connection.input.data() + used, READ_CHUNK);
+        connection.input.resize(used + std::max<ssize_t>(received, 0));
+        if (received > 0) continue;
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            Close(connection);
+            return false;
+        }
+        if (errno != EINTR) break;
+    }
+
+    size_t offset = 0;
+    while (true) {
+        const uint8_t* frame = connection.input.data() + offset;
+        size_t available = connection.input.size() - offset;
+        if (available < FRAME_HEADER_BYTES) break;
+        if (DeclaredPayloadLength(frame) > MAX_REQUEST_BYTES) {
+            Close(connection);
+            return false;
+        }
+        size_t frameSize = CompleteFrameSize(frame, available);
+        if (frameSize == 0) break;
+        HandleMessage(connection, frame, frameSize);
+        offset += frameSize;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    return WriteTo(connection);
+}
+
+bool ServerShard::WriteTo(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.outputSent += sent;
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else {
+            Close(connection);
+            return false;
+        }
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+void ServerShard::UpdateEvents(Connection& connection) {
+    size_t pending = connection.output.size() - connection.outputSent;
+    uint32_t events = (pending < MAX_PENDING_OUTPUT ? (uint32_t)EPOLLIN : 0) | (pending > 0 ? (uint32_t)EPOLLOUT : 0);
+    if (events == connection.events) return;
+    connection.events = events;
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = connection.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void ServerShard::Close(Connection& connection) {
+    ConnectionRef self = {index, connection.fd, connection.serial};
+    for (uint32_t sessionId : connection.watching) {
+        unsigned int owner = sessionId % shardCount;
+        if (owner == index) {
+            RemoveSpectator(sessionId, self);
+        } else if (!peers.empty()) {
+            peers[owner]->Post({ShardMessage::UNSPECTATE, self.fd, self.serial, index, sessionId, nullptr});
+        }
+    }
+    for (uint32_t sessionId : connection.sessions) EndSessionOf(self, sessionId);
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+    close(connection.fd);
+    connections.erase(connection.fd);
+}
+
+// Runs a request here if this shard owns its session and forwards it otherwise. A NEW_GAME
+// for a new session goes to the connection's next shard in turn, and is counted against the
+// connection's limit before it leaves.
+void ServerShard::HandleMessage(Connection& connection, const uint8_t* frame, size_t frameSize) {
+    MessageReader message(frame + FRAME_HEADER_BYTES, frameSize - FRAME_HEADER_BYTES);
+    uint8_t type = message.GetU8();
+    uint32_t sessionId = message.GetU32();
+    if (!message.IsValid()) {
+        SendError(ReplyBuffer(connection), 0, ERROR_MALFORMED);
+        return;
+    }
+    if (type == MSG_SPECTATE || type == MSG_UNSPECTATE) {
+        if (message.GetRemaining() != 0) SendError(ReplyBuffer(connection), sessionId, ERROR_MALFORMED);
+        else HandleSpectate(connection, type, sessionId);
+        return;
+    }
+
+    unsigned int owner = sessionId % shardCount;
+    if (type == MSG_NEW_GAME && sessionId == 0) {
+        if (connection.sessions.size() + connection.sessionsStarting >= MAX_SESSIONS_PER_CONNECTION) {
+            SendError(ReplyBuffer(connection), sessionId, ERROR_TOO_MANY_SESSIONS);
+            return;
+        }
+        owner = connection.nextOwner;
+        connection.nextOwner = (owner + 1) % shardCount;
+        connection.sessionsStarting++;
+    }
+    if (owner != index) {
+        Forward(connection, owner, frame, frameSize);
+        return;
+    }
+    ConnectionRef self = {index, connection.fd, connection.serial};
+    SessionChange change = Execute(self, frame + FRAME_HEADER_BYTES, frameSize - FRAME_HEADER_BYTES, ReplyBuffer(connection), sessionId);
+    NoteSessionChange(connection, change, sessionId);
+}
+
+// Where the reply to the request being handled goes: straight out, or into a slot behind the
+// forwarded requests still waiting on theirs.
+std::vector<uint8_t>& ServerShard::ReplyBuffer(Connection& connection) {
+    if (connection.pending.empty()) {
+        connection.firstPending++;
+        return connection.output;
+    }
+    connection.pending.emplace_back();
+    connection.pending.back().ready = true;
+    return connection.pending.back().bytes;
+}
+
+// Entries are u32 fd, u32 serial, u64 request number, then the request frame as received.
+void ServerShard::Forward(Connection& connection, unsigned int owner, const uint8_t* frame, size_t frameSize) {
+    uint64_t request = connection.firstPending + connection.pending.size();
+    connection.pending.emplace_back();
+    std::vector<uint8_t>& out = outgoingRequests[owner];
+    PutU32(out, (uint32_t)connection.fd);
+    PutU32(out, connection.serial);
+    PutU64(out, request);
+    out.insert(out.end(), frame, frame + frameSize);
+}
+
+// Reply entries are the request's u32 fd, u32 serial and u64 request number, a u8
+// SessionChange, then the reply frame.
+void ServerShard::HandleRequests(const std::vector<uint8_t>& entries, unsigned int from) {
+    std::vector<uint8_t>& out = outgoingReplies[from];
+    MessageReader reader(entries.data(), entries.size());
+    while (reader.GetRemaining() > 0) {
+        ConnectionRef connection = {from, (int)reader.GetU32(), reader.GetU32()};
+        uint64_t request = reader.GetU64();
+        size_t payloadSize = DeclaredPayloadLength(reader.GetBytes(FRAME_HEADER_BYTES));
+        const uint8_t* payload = reader.GetBytes(payloadSize);
+
+        PutU32(out, (uint32_t)connection.fd);
+        PutU32(out, connection.serial);
+        PutU64(out, request);
+        size_t changeAt = out.size();
+        PutU8(out, NO_CHANGE);
+        uint32_t sessionId = 0;
+        out[changeAt] = Execute(connection, payload, payloadSize, out, sessionId);
+    }
+}
+
+// A reply is sent as soon as every earlier request on its connection has been answered, and
+// sends any later ones that were waiting on it.
+void ServerShard::HandleReplies(const std::vector<uint8_t>& entries) {
+    MessageReader reader(entries.data(), entries.size());
+    while (reader.GetRemaining() > 0) {
+        int fd = (int)reader.GetU32();
+        uint32_t serial = reader.GetU32();
+        uint64_t request = reader.GetU64();
+        SessionChange change = (SessionChange)reader.GetU8();
+        const uint8_t* reply = reader.GetBytes(FRAME_HEADER_BYTES);
+        size_t replySize = FRAME_HEADER_BYTES + DeclaredPayloadLength(reply);
+        reader.GetBytes(replySize - FRAME_HEADER_BYTES);
+        MessageReader header(reply + FRAME_HEADER_BYTES, replySize - FRAME_HEADER_BYTES);
+        header.GetU8();
+        uint32_t sessionId = header.GetU32();
+
+        auto found = connections.find(fd);
+        if (found == connections.end() || found->second.serial != serial) {
+            // The connection closed while the request was away, so nothing else will end this.
+            if (change == STARTED) EndSessionOf({index, fd, serial}, sessionId);
+            continue;
+        }
+        Connection& connection = found->second;
+        NoteSessionChange(connection, change, sessionId);
+
+        size_t slot = request - connection.firstPending;
+        if (slot != 0) {
+            connection.pending[slot].bytes.assign(reply, reply + replySize);
+            connection.pending[slot].ready = true;
+            continue;
+        }
+        if (connection.output.size() == connection.outputSent) flushPending.push_back(fd);
+        connection.output.insert(connection.output.end(), reply, reply + replySize);
+        connection.pending.pop_front();
+        connection.firstPending++;
+        while (!connection.pending.empty() && connection.pending.front().ready) {
+            std::vector<uint8_t>& bytes = connection.pending.front().bytes;
+            connection.output.insert(connection.output.end(), bytes.begin(), bytes.end());
+            connection.pending.pop_front();
+            connection.firstPending++;
+        }
+    }
+}
+
+void ServerShard::NoteSessionChange(Connection& connection, SessionChange change, uint32_t sessionId) {
+    if (change == STARTED || change == START_FAILED) connection.sessionsStarting--;
+    if (change == STARTED) connection.sessions.push_back(sessionId);
+    if (change == ENDED) {
+        auto found = std::find(connection.sessions.begin(), connection.sessions.end(), sessionId);
+        if (found != connection.sessions.end()) connection.sessions.erase(found);
+    }
+}
+
+// Everything forwarded during one pass of the event loop goes out as one message per shard.
+void ServerShard::PostForwarded() {
+    for (unsigned int shard = 0; shard < peers.size(); ++shard) {
+        if (!outgoingRequests[shard].empty()) {
+            auto entries = std::make_shared<const std::vector<uint8_t>>(std::move(outgoingRequests[shard]));
+            peers[shard]->Post({ShardMessage::REQUESTS, -1, 0, index, 0, entries});
+            outgoingRequests[shard].clear();
+        }
+        if (!outgoingReplies[shard].empty()) {
+            auto entries = std::make_shared<const std::vector<uint8_t>>(std::move(outgoingReplies[shard]));
+            peers[shard]->Post({ShardMessage::REPLIES, -1, 0, index, 0, entries});
+            outgoingReplies[shard].clear();
+        }
+    }
+}
+
+// The request's header was checked by the connection's shard.
+ServerShard::SessionChange ServerShard::Execute(const ConnectionRef& from, const uint8_t* payload, size_t size,
+                                                std::vector<uint8_t>& out, uint32_t& sessionId) {
+    MessageReader message(payload, size);
+    uint8_t type = message.GetU8();
+    sessionId = message.GetU32();
+    if (type == MSG_NEW_GAME) return HandleNewGame(from, sessionId, message, out);
+    if (type == MSG_MOVES) {
+        HandleMoves(from, sessionId, message, out);
+        return NO_CHANGE;
+    }
+
+    uint32_t cell = (type == MSG_REVEAL || type == MSG_FLAG) ? message.GetU32() : 0;
+    if (!message.IsValid() || message.GetRemaining() != 0) {
+        SendError(out, sessionId, ERROR_MALFORMED);
+        return NO_CHANGE;
+    }
+    Session* session = FindSession(from, sessionId);
+    if (!session) {
+        SendError(out, sessionId, ERROR_NO_SESSION);
+        return NO_CHANGE;
+    }
+    MineField& field = session->field;
+
+    switch (type) {
+        case MSG_REVEAL:
+        case MSG_FLAG: {
+            if (cell >= (uint32_t)field.GetCellCount()) {
+                SendError(out, sessionId, ERROR_MALFORMED);
+                return NO_CHANGE;
+            }
+            int changed = (type == MSG_REVEAL) ? field.RevealCell((int)cell) : (int)field.ToggleFlag((int)cell);
+            FinishAction(*session, sessionId, 1);
+            size_t start = BeginMessage(out, MSG_MOVE_RESULT, sessionId);
+            PutU8(out, (uint8_t)field.GetState());
+            PutU32(out, (uint32_t)changed);
+            AppendActionFrame(out);
+            EndMessage(out, start);
+            return NO_CHANGE;
+        }
+        case MSG_GET_STATE: {
+            size_t start = BeginMessage(out, MSG_STATE, sessionId);
+            PutU8(out, (uint8_t)field.GetState());
+            PutU16(out, (uint16_t)field.GetColumns());
+            PutU16(out, (uint16_t)field.GetRows());
+            PutU32(out, (uint32_t)field.GetTotalMines());
+            PutU32(out, (uint32_t)field.GetFlagsPlaced());
+            for (int i = 0; i < field.GetCellCount(); ++i) PutU8(out, EncodeCell(field, i));
+            EndMessage(out, start);
+            return NO_CHANGE;
+        }
+        case MSG_END_GAME: {
+            EndSession(sessionId);
+            EndMessage(out, BeginMessage(out, MSG_GAME_ENDED, sessionId));
+            return ENDED;
+        }
+        default:
+            SendError(out, sessionId, ERROR_MALFORMED);
+            return NO_CHANGE;
+    }
+}
+
+// Session 0 starts a new session; an existing id starts a new game in that session, which
+// reuses its storage.
+ServerShard::SessionChange ServerShard::HandleNewGame(const ConnectionRef& from, uint32_t& sessionId,
+                                                      MessageReader& message, std::vector<uint8_t>& out) {
+    SessionChange failed = (sessionId == 0) ? START_FAILED : NO_CHANGE;
+    int columns = message.GetU16();
+    int rows = message.GetU16();
+    long long mines = message.GetU32();
+    unsigned long long seed = message.GetU64();
+    if (!message.IsValid() || message.GetRemaining() != 0) {
+        SendError(out, sessionId, ERROR_MALFORMED);
+        return failed;
+    }
+    if (columns <= 0 || rows <= 0 || (long long)columns * rows > MAX_CELLS || mines >= (long long)columns * rows) {
+        SendError(out, sessionId, ERROR_BAD_BOARD);
+        return failed;
+    }
+
+    Session* session = nullptr;
+    SessionChange change = NO_CHANGE;
+    if (sessionId == 0) {
+        // Ids are handed out so that id % shardCount is always this shard.
+        do {
+            sessionId = nextSessionId;
+            nextSessionId = (nextSessionId > UINT32_MAX - shardCount) ? index + shardCount : nextSessionId + shardCount;
+        } while (sessions.count(sessionId));
+        session = &sessions[sessionId];
+        session->owner = from;
+        change = STARTED;
+    } else {
+        session = FindSession(from, sessionId);
+        if (!session) {
+            SendError(out, sessionId, ERROR_NO_SESSION);
+            return failed;
+        }
+    }
+
+    while (seed == 0) seed = seedGenerator();
+    session->field.Initialize(columns, rows, (int)mines, seed);
+    session->moves = 0;
+    session->reported = false;
+    session->stream.Reset();
+    gamesStarted++;
+    if (!session->spectators.empty()) {
+        auto frames = std::make_shared<std::vector<uint8_t>>();
+        size_t start = BeginMessage(*frames, MSG_STREAM, sessionId);
+        session->stream.EncodeKeyframe(session->field, *frames);
+        EndMessage(*frames, start);
+        Broadcast(*session, frames);
+    }
+
+    // The owner's own copy of the stream starts here, so it never needs a GET_STATE.
+    size_t start = BeginMessage(out, MSG_GAME_STARTED, sessionId);
+    PutU64(out, seed);
+    session->stream.EncodeKeyframe(session->field, out);
+    EndMessage(out, start);
+    return change;
+}
+
+// Everything is checked before the first move is applied, so a bad batch changes nothing.
+void ServerShard::HandleMoves(const ConnectionRef& from, uint32_t sessionId, MessageReader& message, std::vector<uint8_t>& out) {
+    size_t count = message.GetU16();
+    if (!message.IsValid() || count > MAX_BATCH_MOVES || message.GetRemaining() != count * 5) {
+        SendError(out, sessionId, ERROR_MALFORMED);
+        return;
+    }
+    Session* session = FindSession(from, sessionId);
+    if (!session) {
+        SendError(out, sessionId, ERROR_NO_SESSION);
+        return;
+    }
+    MineField& field = session->field;
+
+    batch.resize(count);
+    for (MineField::Move& move : batch) {
+        uint8_t kind = message.GetU8();
+        uint32_t cell = message.GetU32();
+        if (kind > MineField::MOVE_CHORD || cell >= (uint32_t)field.GetCellCount()) {
+            SendError(out, sessionId, ERROR_MALFORMED);
+            return;
+        }
+        move.cell = (int)cell;
+        move.kind = (MineField::MoveKind)kind;
+    }
+
+    size_t applied = field.ApplyMoves(batch);
+    FinishAction(*session, sessionId, (uint32_t)applied);
+    size_t start = BeginMessage(out, MSG_MOVES_RESULT, sessionId);
+    PutU8(out, (uint8_t)field.GetState());
+    PutU16(out, (uint16_t)applied);
+    AppendActionFrame(out);
+    EndMessage(out, start);
+}
+
+// Bookkeeping after moves have been applied to a session: counters, reporting a finished
+// game, and one stream frame for everything the moves changed. The frame is encoded even
+// without spectators, since the owner's reply carries it too.
+void ServerShard::FinishAction(Session& session, uint32_t sessionId, uint32_t moves) {
+    movesHandled += moves;
+    session.moves += moves;
+    if (session.field.GetState() != MineField::PLAYING && !session.reported) {
+        session.reported = true;
+        results.Push({sessionId, session.field.GetState() == MineField::WIN, session.moves});
+    }
+    actionFrame.clear();
+    if (session.stream.EncodeAction(session.field, actionFrame) && !session.spectators.empty()) {
+        StreamAction(session, sessionId);
+    }
+}
+
+// Empty when the action changed nothing.
+void ServerShard::AppendActionFrame(std::vector<uint8_t>& out) const {
+    out.insert(out.end(), actionFrame.begin(), actionFrame.end());
+}
+
+ServerShard::Session* ServerShard::FindSession(const ConnectionRef& from, uint32_t sessionId) {
+    auto found = sessions.find(sessionId);
+    if (found == sessions.end() || !(found->second.owner == from)) return nullptr;
+    return &found->second;
+}
+
+void ServerShard::SendError(std::vector<uint8_t>& out, uint32_t sessionId, ServerError error) {
+    size_t start = BeginMessage(out, MSG_ERROR, sessionId);
+    PutU8(out, error);
+    EndMessage(out, start);
+}
+
+// The session's own shard keeps its spectator list, so a request for a session elsewhere
+// is forwarded there. Neither request gets a reply of its own: a spectator's first STREAM
+// message (or an ERROR) comes from the owning shard.
+void ServerShard::HandleSpectate(Connection& connection, uint8_t type, uint32_t sessionId) {
+    auto watched = std::find(connection.watching.begin(), connection.watching.end(), sessionId);
+    if (type == MSG_SPECTATE && watched == connection.watching.end()) {
+        if (connection.watching.size() >= MAX_SESSIONS_PER_CONNECTION) {
+            SendError(ReplyBuffer(connection), sessionId, ERROR_TOO_MANY_SESSIONS);
+            return;
+        }
+        connection.watching.push_back(sessionId);
+    } else if (type == MSG_UNSPECTATE) {
+        if (watched == connection.watching.end()) return;
+        connection.watching.erase(watched);
+    }
+
+    ConnectionRef self = {index, connection.fd, connection.serial};
+    unsigned int owner = sessionId % shardCount;
+    ShardMessage::Kind kind = (type == MSG_SPECTATE) ? ShardMessage::SPECTATE : ShardMessage::UNSPECTATE;
+    if (owner != index) {
+        peers[owner]->Post({kind, self.fd, self.serial, index, sessionId, nullptr});
+    } else if (kind == ShardMessage::SPECTATE) {
+        AddSpectator(sessionId, self);
+    } else {
+        RemoveSpectator(sessionId, self);
+    }
+}
+
+// Spectating a session twice just resends the keyframe, which is how a client resyncs.
+void ServerShard::AddSpectator(uint32_t sessionId, const ConnectionRef& spectator) {
+    auto frames = std::make_shared<std::vector<uint8_t>>();
+    auto found = sessions.find(sessionId);
+    if (found == sessions.end()) {
+        size_t start = BeginMessage(*frames, MSG_ERROR, sessionId);
+        PutU8(*frames, ERROR_NO_SESSION);
+        EndMessage(*frames, start);
+    } else {
+        Session& session = found->second;
+        if (std::find(session.spectators.begin(), session.spectators.end(), spectator) == session.spectators.end()) {
+            session.spectators.push_back(spectator);
+        }
+        size_t start = BeginMessage(*frames, MSG_STREAM, sessionId);
+        session.stream.EncodeKeyframe(session.field, *frames);
+        EndMessage(*frames, start);
+    }
+    Deliver(spectator, frames);
+}
+
+void ServerShard::RemoveSpectator(uint32_t sessionId, const ConnectionRef& spectator) {
+    auto found = sessions.find(sessionId);
+    if (found == sessions.end()) return;
+    std::vector<ConnectionRef>& spectators = found->second.spectators;
+    spectators.erase(std::remove(spectators.begin(), spectators.end(), spectator), spectators.end());
+}
+
+void ServerShard::StreamAction(Session& session, uint32_t sessionId) {
+    auto frames = std::make_shared<std::vector<uint8_t>>();
+    size_t start = BeginMessage(*frames, MSG_STREAM, sessionId);
+    frames->insert(frames->end(), actionFrame.begin(), actionFrame.end());
+    EndMessage(*frames, start);
+    Broadcast(session, frames);
+}
+
+void ServerShard::EndSession(uint32_t sessionId) {
+    auto found = sessions.find(sessionId);
+    if (found == sessions.end()) return;
+    if (!found->second.spectators.empty()) {
+        auto frames = std::make_shared<std::vector<uint8_t>>();
+        EndMessage(*frames, BeginMessage(*frames, MSG_GAME_ENDED, sessionId));
+        Broadcast(found->second, frames);
+    }
+    sessions.erase(found);
+}
+
+// Only a session the connection still owns is ended: by the time the message arrives, its
+// id may have been given to another connection's session.
+void ServerShard::EndSessionOf(const ConnectionRef& owner, uint32_t sessionId) {
+    unsigned int shard = sessionId % shardCount;
+    if (shard != index) {
+        if (!peers.empty()) peers[shard]->Post({ShardMessage::END_SESSION, owner.fd, owner.serial, owner.shard, sessionId, nullptr});
+        return;
+    }
+    auto found = sessions.find(sessionId);
+    if (found != sessions.end() && found->second.owner == owner) EndSession(sessionId);
+}
+
+void ServerShard::Broadcast(const Session& session, const std::shared_ptr<const std::vector<uint8_t>>& frames) {
+    for (const ConnectionRef& spectator : session.spectators) Deliver(spectator, frames);
+}
+
+void ServerShard::Deliver(const ConnectionRef& spectator, const std::shared_ptr<const std::vector<uint8_t>>& frames) {
+    if (spectator.shard == index) {
+        DeliverLocal(spectator.fd, spectator.serial, *frames);
+    } else if (!peers.empty()) {
+        peers[spectator.shard]->Post({ShardMessage::DELIVER, spectator.fd, spectator.serial, index, 0, frames});
+    }
+}
+
+void ServerShard::DeliverLocal(int fd, uint32_t serial, const std::vector<uint8_t>& frames) {
+    auto found = connections.find(fd);
+    if (found == connections.end() || found->second.serial != serial) return;
+    Connection& connection = found->second;
+    if (connection.output.size() - connection.outputSent >= MAX_PENDING_OUTPUT) return;
+    if (connection.output.size() == connection.outputSent) flushPending.push_back(fd);
+    connection.output.insert(connection.output.end(), frames.begin(), frames.end());
+}
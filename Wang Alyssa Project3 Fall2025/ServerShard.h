@@ -0,0 +1,189 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_SERVERSHARD_H
+#define MINESWEEPER_SERVERSHARD_H
+
+#include "MineField.h"
+#include "MpscQueue.h"
+#include "ServerProtocol.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// A finished game, passed from the shard that played it to the server's aggregator.
+struct GameResult {
+    uint32_t session = 0;
+    bool won = false;
+    uint32_t moves = 0;
+};
+
+// Work handed to a shard by another thread: a new connection, a spectator joining or
+// leaving one of its sessions, stream frames for one of its spectator connections, a batch
+// of requests for its sessions or of replies for its connections, or a session to end
+// because the connection that started it closed.
+struct ShardMessage {
+    enum Kind { ADOPT, SPECTATE, UNSPECTATE, DELIVER, REQUESTS, REPLIES, END_SESSION };
+    Kind kind = ADOPT;
+    // The new connection, or the connection the message is about.
+    int fd = -1;
+    // Tells a connection apart from a later one that reused its fd.
+    uint32_t serial = 0;
+    // The sending shard, which is also the home of the connection the message is about.
+    unsigned int shard = 0;
+    uint32_t session = 0;
+    // Stream frames for DELIVER; the forwarded entries for REQUESTS and REPLIES.
+    std::shared_ptr<const std::vector<uint8_t>> frames;
+};
+
+// One worker thread of the game server with its own epoll loop. It owns the connections
+// handed to it and the sessions whose id % shardCount == index, so a MineField is only ever
+// touched by the thread of its shard. A connection deals the sessions it starts round all
+// the shards; a request for a session on another shard is forwarded to it through the
+// shards' inboxes, and its reply comes back the same way and waits until every earlier
+// reply on that connection has gone out. Forwarded requests and replies travel in one
+// batch per shard per pass of the event loop. Finished games leave through the results
+// queue. A move is encoded once however many spectators it has.
+class ServerShard {
+public:
+    static const size_t MAX_SESSIONS_PER_CONNECTION = 4096;
+    // Keeps a full STATE message around a megabyte, and every game streamable.
+    static const int MAX_CELLS = StateStream::MAX_CELLS;
+
+    ServerShard(unsigned int index, unsigned int shardCount, MpscQueue<GameResult>& results);
+    ~ServerShard();
+    // Every shard, this one included, indexed by shard number. Call before Start().
+    void SetPeers(const std::vector<ServerShard*>& peers);
+    // Starts the thread. The stop eventfd is shared by all shards.
+    bool Start(int wakeFd);
+    void Join();
+    // Queues work for this shard's thread. Safe from any thread.
+    void Post(ShardMessage message);
+
+    // Only read these after Join().
+    unsigned long long GetMovesHandled() const { return movesHandled; }
+    unsigned long long GetGamesStarted() const { return gamesStarted; }
+
+private:
+    // A connection on any shard.
+    struct ConnectionRef {
+        unsigned int shard;
+        int fd;
+        uint32_t serial;
+        bool operator==(const ConnectionRef& other) const {
+            return shard == other.shard && fd == other.fd && serial == other.serial;
+        }
+    };
+
+    // What a request did to its connection's list of sessions, reported with its reply.
+    enum SessionChange : uint8_t { NO_CHANGE, STARTED, START_FAILED, ENDED };
+
+    struct Session {
+        MineField field;
+        ConnectionRef owner;
+        uint32_t moves = 0;
+        bool reported = false;
+        StateStream stream;
+        std::vector<ConnectionRef> spectators;
+    };
+
+    // A reply that came back from another shard before the replies ahead of it.
+    struct PendingReply {
+        bool ready = false;
+        std::vector<uint8_t> bytes;
+    };
+
+    struct Connection {
+        int fd = -1;
+        uint32_t serial = 0;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+        // Sessions this connection started, on any shard, and how many NEW_GAMEs for new
+        // sessions haven't been answered yet.
+        std::vector<uint32_t> sessions;
+        size_t sessionsStarting = 0;
+        // The shard that gets the next new session.
+        unsigned int nextOwner = 0;
+        // Replies held back behind a forwarded request, one slot per request from the oldest
+        // unanswered forwarded one on; firstPending numbers the request in the front slot.
+        std::deque<PendingReply> pending;
+        uint64_t firstPending = 0;
+        // Sessions this connection spectates, on any shard.
+        std::vector<uint32_t> watching;
+        uint32_t events = 0;
+    };
+
+    unsigned int index;
+    unsigned int shardCount;
+    MpscQueue<GameResult>& results;
+    std::vector<ServerShard*> peers;
+    MpscQueue<ShardMessage> inbox;
+    int inboxFd = -1;
+    int wakeFd = -1;
+    int epollFd = -1;
+    std::thread thread;
+    std::unordered_map<int, Connection> connections;
+    std::unordered_map<uint32_t, Session> sessions;
+    uint32_t nextSessionId;
+    uint32_t nextSerial = 1;
+    // Connections that got stream frames and need a write attempt.
+    std::vector<int> flushPending;
+    // Scratch for decoding MOVES requests, reused so a batch doesn't allocate.
+    std::vector<MineField::Move> batch;
+    // The last action's stream frame, copied into the reply and to any spectators.
+    std::vector<uint8_t> actionFrame;
+    // Requests and replies for each other shard, posted once per pass of the event loop.
+    std::vector<std::vector<uint8_t>> outgoingRequests;
+    std::vector<std::vector<uint8_t>> outgoingReplies;
+    std::mt19937_64 seedGenerator{std::random_device{}()};
+    unsigned long long movesHandled = 0;
+    unsigned long long gamesStarted = 0;
+
+    void Run();
+    void ProcessInbox();
+    void AddConnection(int fd);
+    void FlushPending();
+    // Both return false once the connection has been closed.
+    bool ReadFrom(Connection& connection);
+    bool WriteTo(Connection& connection);
+    void UpdateEvents(Connection& connection);
+    void Close(Connection& connection);
+
+    // Routing, on the connection's shard.
+    void HandleMessage(Connection& connection, const uint8_t* frame, size_t frameSize);
+    std::vector<uint8_t>& ReplyBuffer(Connection& connection);
+    void Forward(Connection& connection, unsigned int owner, const uint8_t* frame, size_t frameSize);
+    void HandleReplies(const std::vector<uint8_t>& entries);
+    void NoteSessionChange(Connection& connection, SessionChange change, uint32_t sessionId);
+    void PostForwarded();
+
+    // Requests, on the session's shard. Each writes exactly one reply message to out.
+    void HandleRequests(const std::vector<uint8_t>& entries, unsigned int from);
+    SessionChange Execute(const ConnectionRef& from, const uint8_t* payload, size_t size, std::vector<uint8_t>& out, uint32_t& sessionId);
+    SessionChange HandleNewGame(const ConnectionRef& from, uint32_t& sessionId, MessageReader& message, std::vector<uint8_t>& out);
+    void HandleMoves(const ConnectionRef& from, uint32_t sessionId, MessageReader& message, std::vector<uint8_t>& out);
+    void FinishAction(Session& session, uint32_t sessionId, uint32_t moves);
+    Session* FindSession(const ConnectionRef& from, uint32_t sessionId);
+    static void SendError(std::vector<uint8_t>& out, uint32_t sessionId, ServerError error);
+
+    void HandleSpectate(Connection& connection, uint8_t type, uint32_t sessionId);
+    void AddSpectator(uint32_t sessionId, const ConnectionRef& spectator);
+    void RemoveSpectator(uint32_t sessionId, const ConnectionRef& spectator);
+    void StreamAction(Session& session, uint32_t sessionId);
+    void AppendActionFrame(std::vector<uint8_t>& out) const;
+    void EndSession(uint32_t sessionId);
+    // Ends a session of a closed connection, on whichever shard it lives.
+    void EndSessionOf(const ConnectionRef& owner, uint32_t sessionId);
+    void Broadcast(const Session& session, const std::shared_ptr<const std::vector<uint8_t>>& frames);
+    void Deliver(const ConnectionRef& spectator, const std::shared_ptr<const std::vector<uint8_t>>& frames);
+    void DeliverLocal(int fd, uint32_t serial, const std::vector<uint8_t>& frames);
+};
+
+#endif //MINESWEEPER_SERVERSHARD_H
@@ -0,0 +1,222 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "StateStream.h"
+#include <algorithm>
+
+uint8_t EncodeCell(const MineField& field, int cell) {
+    if (field.IsRevealed(cell)) {
+        return field.IsMine(cell) ? (uint8_t)CELL_MINE : (uint8_t)field.GetAdjacentMines(cell);
+    }
+    return field.HasFlag(cell) ? (uint8_t)CELL_FLAG : (uint8_t)CELL_HIDDEN;
+}
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool GetVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void StateStream::Reset() {
+    sequence = 0;
+    framesSinceKeyframe = 0;
+    lastState = MineField::PLAYING;
+}
+
+bool StateStream::EncodeAction(const MineField& field, std::vector<uint8_t>& out) {
+    bool stateChanged = field.GetState() != lastState;
+    lastState = field.GetState();
+    if (!stateChanged && field.GetChangedCells().empty()) return false;
+
+    sequence++;
+    if (stateChanged || ++framesSinceKeyframe >= KEYFRAME_INTERVAL) {
+        EncodeKeyframe(field, out);
+        framesSinceKeyframe = 0;
+        return true;
+    }
+
+    revealed.clear();
+    toggled.clear();
+    for (int cell : field.GetChangedCells()) {
+        (field.IsRevealed(cell) ? revealed : toggled).push_back(cell);
+    }
+    // A batch of moves can flag and unflag a cell, or unflag and then reveal it, so a cell
+    // may be listed more than once: keep each revealed cell once, and only the flags that
+    // toggled an odd number of times.
+    std::sort(revealed.begin(), revealed.end());
+    revealed.erase(std::unique(revealed.begin(), revealed.end()), revealed.end());
+    std::sort(toggled.begin(), toggled.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < toggled.size();) {
+        size_t same = i;
+        while (same < toggled.size() && toggled[same] == toggled[i]) same++;
+        if ((same - i) % 2) toggled[kept++] = toggled[i];
+        i = same;
+    }
+    toggled.resize(kept);
+
+    out.push_back(DELTA);
+    PutVarint(out, sequence);
+    out.push_back((uint8_t)field.GetState());
+
+    // Count the runs first so the count can lead.
+    size_t spanCount = 0;
+    for (size_t i = 0; i < revealed.size(); ++i) {
+        if (i == 0 || revealed[i] != revealed[i - 1] + 1) spanCount++;
+    }
+    PutVarint(out, spanCount);
+    int previousEnd = 0;
+    for (size_t first = 0; first < revealed.size();) {
+        size_t last = first;
+        while (last + 1 < revealed.size() && revealed[last + 1] == revealed[last] + 1) last++;
+        PutVarint(out, revealed[first] - previousEnd);
+        PutVarint(out, last - first + 1);
+        for (size_t i = first; i <= last; i += 2) {
+            uint8_t low = (uint8_t)field.GetAdjacentMines(revealed[i]);
+            uint8_t high = i + 1 <= last ? (uint8_t)field.GetAdjacentMines(revealed[i + 1]) : 0;
+            out.push_back((uint8_t)(low | (high << 4)));
+        }
+        previousEnd = revealed[last] + 1;
+        first = last + 1;
+    }
+
+    PutVarint(out, toggled.size());
+    int previous = 0;
+    for (int cell : toggled) {
+        PutVarint(out, cell - previous);
+        previous = cell;
+    }
+    return true;
+}
+
+void StateStream::EncodeKeyframe(const MineField& field, std::vector<uint8_t>& out) const {
+    out.push_back(KEYFRAME);
+    PutVarint(out, sequence);
+    out.push_back((uint8_t)field.GetState());
+    PutVarint(out, field.GetColumns());
+    PutVarint(out, field.GetRows());
+    PutVarint(out, field.GetTotalMines());
+    PutVarint(out, field.GetFlagsPlaced());
+    for (int cell = 0; cell < field.GetCellCount();) {
+        uint8_t code = EncodeCell(field, cell);
+        int run = 1;
+        while (cell + run < field.GetCellCount() && EncodeCell(field, cell + run) == code) run++;
+        out.push_back(code);
+        PutVarint(out, run);
+        cell += run;
+    }
+}
+
+bool StateStreamReader::Apply(const uint8_t* data, size_t size) {
+    const uint8_t* end = data + size;
+    if (data == end) return false;
+    uint8_t kind = *data++;
+    if (kind == StateStream::KEYFRAME) return ApplyKeyframe(data, end);
+    if (kind == StateStream::DELTA) return ApplyDelta(data, end);
+    return false;
+}
+
+bool StateStreamReader::ApplyKeyframe(const uint8_t*& data, const uint8_t* end) {
+    uint64_t frameSequence, newColumns, newRows, newMines, newFlags;
+    if (!GetVarint(data, end, frameSequence) || data == end) return false;
+    uint8_t newState = *data++;
+    if (!GetVarint(data, end, newColumns) || !GetVarint(data, end, newRows) ||
+        !GetVarint(data, end, newMines) || !GetVarint(data, end, newFlags)) {
+        return false;
+    }
+    if (newState > MineField::LOSE || newColumns == 0 || newRows == 0 || newColumns > 65535 || newRows > 65535 ||
+        newColumns * newRows > (uint64_t)StateStream::MAX_CELLS) {
+        return false;
+    }
+
+    size_t cellCount = (size_t)(newColumns * newRows);
+    std::vector<uint8_t> newCells;
+    newCells.reserve(cellCount);
+    while (newCells.size() < cellCount) {
+        uint64_t run;
+        if (data == end) return false;
+        uint8_t code = *data++;
+        if (code > CELL_MINE || !GetVarint(data, end, run) || run == 0 || run > cellCount - newCells.size()) return false;
+        newCells.insert(newCells.end(), (size_t)run, code);
+    }
+
+    cells.swap(newCells);
+    sequence = (uint32_t)frameSequence;
+    state = (MineField::GameState)newState;
+    columns = (int)newColumns;
+    rows = (int)newRows;
+    mines = (int)newMines;
+    flags = (int)newFlags;
+    synced = true;
+    return data == end;
+}
+
+bool StateStreamReader::ApplyDelta(const uint8_t*& data, const uint8_t* end) {
+    uint64_t frameSequence;
+    if (!GetVarint(data, end, frameSequence) || data == end) return false;
+    uint8_t newState = *data++;
+    if (newState > MineField::LOSE) return false;
+    if (!synced || frameSequence != (uint64_t)sequence + 1) {
+        synced = false;
+        return true;
+    }
+
+    // Check the whole frame before touching the board, so a bad frame leaves it intact.
+    for (int pass = 0; pass < 2; ++pass) {
+        const uint8_t* position = data;
+        bool applying = (pass == 1);
+        uint64_t spanCount, flagCount, gap, length;
+        uint64_t cell = 0;
+        // Every bound compares against what is left rather than adding to the frame's values,
+        // so a huge gap or length can't wrap around and pass.
+        if (!GetVarint(position, end, spanCount)) return false;
+        for (uint64_t span = 0; span < spanCount; ++span) {
+            if (!GetVarint(position, end, gap) || !GetVarint(position, end, length)) return false;
+            if (gap > cells.size() - cell) return false;
+            cell += gap;
+            if (length == 0 || length > cells.size() - cell) return false;
+            if ((uint64_t)(end - position) < length / 2 + length % 2) return false;
+            for (uint64_t i = 0; i < length; ++i) {
+                uint8_t number = (position[i / 2] >> (4 * (i % 2))) & 0x0f;
+                if (number > 8) return false;
+                if (!applying) continue;
+                // Only a flag taken off earlier in the same batch can end up revealed.
+                if (cells[cell + i] == CELL_FLAG) flags--;
+                cells[cell + i] = number;
+            }
+            position += length / 2 + length % 2;
+            cell += length;
+        }
+
+        cell = 0;
+        if (!GetVarint(position, end, flagCount)) return false;
+        for (uint64_t i = 0; i < flagCount; ++i) {
+            if (!GetVarint(position, end, gap) || gap >= cells.size() - cell) return false;
+            cell += gap;
+            if (applying) {
+                bool flagging = cells[cell] == CELL_HIDDEN;
+                cells[cell] = flagging ? CELL_FLAG : CELL_HIDDEN;
+                flags += flagging ? 1 : -1;
+            }
+        }
+        if (position != end) return false;
+    }
+
+    sequence = (uint32_t)frameSequence;
+    state = (MineField::GameState)newState;
+    data = end;
+    return true;
+}
@@ -0,0 +1,93 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_STATESTREAM_H
+#define MINESWEEPER_STATESTREAM_H
+
+#include "MineField.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How a cell looks to someone who can't see the mines: 0-8 is a revealed number.
+enum CellCode : uint8_t {
+    CELL_HIDDEN = 9,
+    CELL_FLAG = 10,
+    CELL_MINE = 11
+};
+
+uint8_t EncodeCell(const MineField& field, int cell);
+
+// Compact per-action change sets for spectators, so watching costs bandwidth in proportion
+// to what happens rather than to the board size. Integers are LEB128 varints.
+//
+//   KEYFRAME  u8 1, sequence, u8 state, columns, rows, mines, flags,
+//             then (u8 cell code, run length) pairs covering every cell in order
+//   DELTA     u8 2, sequence, u8 state,
+//             span count, then per span: gap from the previous span's end, length,
+//                 and the revealed numbers packed two per byte (low nibble first),
+//             flag count, then per toggled cell: gap from the previous toggled cell
+//
+// One frame can cover a whole batch of moves, so a revealed cell may have been showing a
+// flag that the batch took off first; the reader drops that flag. Revealed cells are sorted
+// and merged into runs, so a flood fill costs a couple of bytes per row it touches plus half
+// a byte per cell. Deltas carry consecutive sequence numbers; a keyframe is sent whenever
+// the game ends (a win or loss changes too much to be worth a delta) and every
+// KEYFRAME_INTERVAL frames, so a client that fell behind resyncs.
+class StateStream {
+public:
+    enum FrameKind : uint8_t { KEYFRAME = 1, DELTA = 2 };
+    static const uint32_t KEYFRAME_INTERVAL = 64;
+    // The largest board a stream may describe. The server refuses to start bigger games, and
+    // the reader rejects keyframes that claim more cells instead of allocating for them.
+    static const int MAX_CELLS = 1 << 20;
+
+    // Call when a new game starts on the field being streamed.
+    void Reset();
+    // Appends the frame for the action just applied to field. Returns false, appending
+    // nothing, if the action changed nothing.
+    bool EncodeAction(const MineField& field, std::vector<uint8_t>& out);
+    // A keyframe at the current sequence for a spectator joining now; the next frame from
+    // EncodeAction follows on from it.
+    void EncodeKeyframe(const MineField& field, std::vector<uint8_t>& out) const;
+
+private:
+    uint32_t sequence = 0;
+    uint32_t framesSinceKeyframe = 0;
+    MineField::GameState lastState = MineField::PLAYING;
+    std::vector<int> revealed;
+    std::vector<int> toggled;
+};
+
+// The spectator's side: rebuilds the visible board from a stream of frames.
+class StateStreamReader {
+public:
+    // Returns false if the frame is malformed. A delta that doesn't directly follow the last
+    // applied frame is skipped, and IsSynced() stays false until the next keyframe.
+    bool Apply(const uint8_t* data, size_t size);
+
+    bool IsSynced() const { return synced; }
+    uint32_t GetSequence() const { return sequence; }
+    MineField::GameState GetState() const { return state; }
+    int GetColumns() const { return columns; }
+    int GetRows() const { return rows; }
+    int GetTotalMines() const { return mines; }
+    int GetFlagsPlaced() const { return flags; }
+    const std::vector<uint8_t>& GetCells() const { return cells; }
+
+private:
+    bool synced = false;
+    uint32_t sequence = 0;
+    MineField::GameState state = MineField::PLAYING;
+    int columns = 0;
+    int rows = 0;
+    int mines = 0;
+    int flags = 0;
+    std::vector<uint8_t> cells;
+
+    bool ApplyKeyframe(const uint8_t*& data, const uint8_t* end);
+    bool ApplyDelta(const uint8_t*& data, const uint8_t* end);
+};
+
+#endif //MINESWEEPER_STATESTREAM_H
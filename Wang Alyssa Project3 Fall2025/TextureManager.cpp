@@ -3,15 +3,88 @@
 //
 
 #include "TextureManager.h"
+#include "AssetPack.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+static const char* const TEXTURE_FILES[TextureManager::TEXTURE_COUNT] = {
+    "tile_hidden.png", "tile_revealed.png", "mine.png", "flag.png",
+    "face_happy.png", "face_win.png", "face_lose.png",
+    "debug.png", "pause.png", "play.png", "leaderboard.png",
+    "number_1.png", "number_2.png", "number_3.png", "number_4.png",
+    "number_5.png", "number_6.png", "number_7.png", "number_8.png",
+    "digits.png"
+};
+
+const char* TextureManager::GetFileName(TextureID id) {
+    return TEXTURE_FILES[id];
+}
+
+void TextureManager::ResolveHandle(const std::string& fileName, sf::Texture& texture) {
+    // Resolve the handle once here so the draw path never touches the map.
+    for (int id = 0; id < TEXTURE_COUNT; ++id) {
+        if (fileName == TEXTURE_FILES[id]) handles[id] = &texture;
+    }
+}
+
+bool TextureManager::LoadImage(const std::string& fileName, sf::Image& image) const {
+    // Images come from the pack linked into the executable unless an asset directory overrides it.
+    if (!assetDirectory.empty()) {
+        return image.loadFromFile(assetDirectory + "/images/" + fileName);
+    }
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    return AssetPack::Embedded().Find("images/" + fileName, data, size) && image.loadFromMemory(data, size);
+}
 
 void TextureManager::LoadTexture(const std::string& fileName) {
+    TRACE_SCOPE("TextureManager::LoadTexture");
     if (textures.find(fileName) == textures.end()) {
-        std::string path = "files/images/";
-        path += fileName;
-        textures[fileName].loadFromFile(path);
+        sf::Image image;
+        sf::Texture& texture = textures[fileName];
+        if (LoadImage(fileName, image) && texture.loadFromImage(image)) ResolveHandle(fileName, texture);
     }
 }
 
+void TextureManager::LoadTextures(const std::vector<std::string>& fileNames) {
+    TRACE_SCOPE("TextureManager::LoadTextures");
+    // PNG decoding is CPU-only and runs on a small worker pool, while GPU uploads stay on
+    // this thread and start as soon as each image is ready.
+    std::vector<std::promise<std::optional<sf::Image>>> decoded(fileNames.size());
+    std::vector<std::future<std::optional<sf::Image>>> ready;
+    for (auto& promise : decoded) ready.push_back(promise.get_future());
+
+    std::atomic<size_t> next{0};
+    unsigned int workerCount = std::max(1u, std::min<unsigned int>(std::thread::hardware_concurrency(), (unsigned int)fileNames.size()));
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < workerCount; ++w) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < fileNames.size(); i = next++) {
+                TRACE_SCOPE("TextureManager::DecodeImage");
+                sf::Image image;
+                if (LoadImage(fileNames[i], image)) decoded[i].set_value(std::move(image));
+                else decoded[i].set_value(std::nullopt);
+            }
+        });
+    }
+
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        std::optional<sf::Image> image = ready[i].get();
+        if (textures.find(fileNames[i]) != textures.end()) continue;
+
+        sf::Texture& texture = textures[fileNames[i]];
+        if (image && texture.loadFromImage(*image)) ResolveHandle(fileNames[i], texture);
+        else std::cerr << "Error: Could not load " << fileNames[i] << "!" << std::endl;
+    }
+
+    for (std::thread& worker : workers) worker.join();
+}
+
 sf::Texture& TextureManager::GetTexture(const std::string& fileName) {
     if (textures.find(fileName) == textures.end()) {
         LoadTexture(fileName);
@@ -19,6 +92,15 @@ sf::Texture& TextureManager::GetTexture(const std::string& fileName) {
     return textures[fileName];
 }
 
+sf::Texture& TextureManager::GetTexture(TextureID id) {
+    if (!handles[id]) {
+        LoadTexture(TEXTURE_FILES[id]);
+        if (!handles[id]) handles[id] = &textures[TEXTURE_FILES[id]];
+    }
+    return *handles[id];
+}
+
 void TextureManager::Clear() {
     textures.clear();
-}
\ No newline at end of file
+    handles.fill(nullptr);
+}
@@ -6,17 +6,40 @@
 #define MINESWEEPER_TEXTUREMANAGER_H
 
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <map>
 #include <string>
+#include <vector>
 
 class TextureManager {
-private:
-    std::map<std::string, sf::Texture> textures;
-
 public:
+    enum TextureID {
+        TILE_HIDDEN, TILE_REVEALED, MINE, FLAG,
+        FACE_HAPPY, FACE_WIN, FACE_LOSE,
+        DEBUG, PAUSE, PLAY, LEADERBOARD,
+        NUMBER_1, NUMBER_2, NUMBER_3, NUMBER_4, NUMBER_5, NUMBER_6, NUMBER_7, NUMBER_8,
+        DIGITS,
+        TEXTURE_COUNT
+    };
+
+    void SetAssetDirectory(const std::string& directory) { assetDirectory = directory; }
     void LoadTexture(const std::string& fileName);
+    void LoadTextures(const std::vector<std::string>& fileNames);
     sf::Texture& GetTexture(const std::string& fileName);
+    sf::Texture& GetTexture(TextureID id);
     void Clear();
+
+    static const char* GetFileName(TextureID id);
+    static TextureID NumberTexture(int adjacentMines) { return static_cast<TextureID>(NUMBER_1 + adjacentMines - 1); }
+
+private:
+    std::map<std::string, sf::Texture> textures;
+    std::array<sf::Texture*, TEXTURE_COUNT> handles{};
+    std::string assetDirectory;
+
+    bool LoadImage(const std::string& fileName, sf::Image& image) const;
+
+    void ResolveHandle(const std::string& fileName, sf::Texture& texture);
 };
 
-#endif
\ No newline at end of file
+#endif
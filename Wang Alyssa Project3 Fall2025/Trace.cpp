@@ -0,0 +1,125 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#include "Trace.h"
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::enabled{false};
+
+namespace {
+
+const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+struct TraceEvent {
+    const char* name;
+    int64_t start;
+    int64_t duration;
+    int threadId;
+};
+
+// The owning thread appends; Flush reads. The per-buffer mutex is uncontended in practice.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    int threadId = 0;
+};
+
+std::mutex& RegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<ThreadBuffer*>& Registry() {
+    static std::vector<ThreadBuffer*> registry;
+    return registry;
+}
+
+std::vector<TraceEvent>& Retired() {
+    static std::vector<TraceEvent> retired;
+    return retired;
+}
+
+std::string& OutputPath() {
+    static std::string path;
+    return path;
+}
+
+struct ThreadSlot {
+    ThreadBuffer buffer;
+
+    ThreadSlot() {
+        static int nextThreadId = 1;
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        buffer.threadId = nextThreadId++;
+        Registry().push_back(&buffer);
+    }
+
+    ~ThreadSlot() {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+        Retired().insert(Retired().end(), buffer.events.begin(), buffer.events.end());
+        auto& registry = Registry();
+        for (size_t i = 0; i < registry.size(); ++i) {
+            if (registry[i] == &buffer) {
+                registry[i] = registry.back();
+                registry.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+ThreadBuffer& Local() {
+    thread_local ThreadSlot slot;
+    return slot.buffer;
+}
+
+}
+
+void Trace::Enable(const std::string& outputPath) {
+    OutputPath() = outputPath;
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+int64_t Trace::NowMicros() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Trace::Record(const char* name, int64_t startMicros, int64_t durationMicros) {
+    ThreadBuffer& buffer = Local();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < MAX_EVENTS_PER_THREAD) {
+        buffer.events.push_back({name, startMicros, durationMicros, buffer.threadId});
+    }
+}
+
+bool Trace::Flush() {
+    if (!IsEnabled()) return true;
+
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex());
+        events = Retired();
+        for (ThreadBuffer* buffer : Registry()) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+        }
+    }
+
+    std::ofstream file(OutputPath());
+    if (!file.is_open()) return false;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& event = events[i];
+        file << (i == 0 ? "\n" : ",\n")
+             << "{\"name\":\"" << event.name << "\",\"cat\":\"minesweeper\",\"ph\":\"X\",\"ts\":" << event.start
+             << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << event.threadId << "}";
+    }
+    file << "\n]}\n";
+    return file.good();
+}
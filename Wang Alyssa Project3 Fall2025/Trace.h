@@ -0,0 +1,45 @@
+//
+// Created by Alyssa Wang on 2026/10/19.
+//
+
+#ifndef MINESWEEPER_TRACE_H
+#define MINESWEEPER_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timers that record Chrome trace_event "complete" events into per-thread buffers.
+// Tracing is off unless Trace::Enable is called; a disabled TRACE_SCOPE is one relaxed load.
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+class Trace {
+public:
+    static void Enable(const std::string& outputPath);
+    static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static int64_t NowMicros();
+    static void Record(const char* name, int64_t startMicros, int64_t durationMicros);
+    static bool Flush();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name(Trace::IsEnabled() ? name : nullptr), start(this->name ? Trace::NowMicros() : 0) {}
+    ~TraceScope() {
+        if (name) Trace::Record(name, start, Trace::NowMicros() - start);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#endif
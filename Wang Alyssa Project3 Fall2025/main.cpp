@@ -3,97 +3,151 @@
 #include <fstream>
 #include <string>
 #include <cctype>
+#include <cstdio>
 #include <chrono>
 #include <optional>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
 #include "Board.h"
 #include "TextureManager.h"
 #include "Leaderboard.h"
-
-void ReadConfig(int& columns, int& rows, int& mines) {
+#include "LeaderboardService.h"
+#include "Replay.h"
+#include "PlayerStats.h"
+#include "AssetPack.h"
+#include "Hud.h"
+#include "FrameProfiler.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+
+// An optional fourth value sets how many entries each leaderboard keeps.
+void ReadConfig(int& columns, int& rows, int& mines, int& leaderboardSize) {
     std::fstream file("files/config.cfg");
     if (file.is_open()) {
         file >> columns;
         file >> rows;
         file >> mines;
+        if (!(file >> leaderboardSize)) leaderboardSize = Leaderboard::DEFAULT_MAX_ENTRIES;
         file.close();
     } else {
         std::cerr << "Error: Could not open config.cfg file!" << std::endl;
         columns = 25;
         rows = 16;
         mines = 50;
+        leaderboardSize = Leaderboard::DEFAULT_MAX_ENTRIES;
     }
 }
 
+// Daily challenges share one board per UTC day; the seed is the day number.
+unsigned long long DailySeed() {
+    auto now = std::chrono::system_clock::now();
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::hours>(now.time_since_epoch()).count() / 24 + 1;
+}
+
+const sf::Time LEADERBOARD_POLL_INTERVAL = sf::milliseconds(50);
+const sf::Time UNFOCUSED_FRAME_INTERVAL = sf::milliseconds(250);
+const unsigned long long ALLOCATION_CHECK_WARMUP_FRAMES = 60;
+const unsigned long long ALLOCATION_CHECK_FRAMES = 240;
+
+// sf::Time::Zero means "wait forever" for waitEvent, so it loses to any real timeout.
+sf::Time ShorterTimeout(sf::Time current, sf::Time candidate) {
+    if (candidate < sf::milliseconds(1)) candidate = sf::milliseconds(1);
+    if (current == sf::Time::Zero || candidate < current) return candidate;
+    return current;
+}
+
 void setText(sf::Text& text, float x, float y) {
     sf::FloatRect textRect = text.getLocalBounds();
     text.setOrigin({textRect.position.x + textRect.size.x / 2.0f, textRect.position.y + textRect.size.y / 2.0f});
     text.setPosition({x, y});
 }
 
-void LoadAllTextures(TextureManager& textures) {
-    textures.LoadTexture("tile_hidden.png");
-    textures.LoadTexture("tile_revealed.png");
-    textures.LoadTexture("mine.png");
-    textures.LoadTexture("flag.png");
-    textures.LoadTexture("face_happy.png");
-    textures.LoadTexture("face_win.png");
-    textures.LoadTexture("face_lose.png");
-    textures.LoadTexture("debug.png");
-    textures.LoadTexture("pause.png");
-    textures.LoadTexture("play.png");
-    textures.LoadTexture("leaderboard.png");
-    for (int i = 1; i <= 8; ++i) {
-        textures.LoadTexture("number_" + std::to_string(i) + ".png");
-    }
-    textures.LoadTexture("digits.png");
+// The leaderboard window lives for the whole session and is only shown or hidden.
+void ShowLeaderboardWindow(sf::RenderWindow& leaderboardWindow, const sf::RenderWindow& window) {
+    sf::Vector2u size = window.getSize();
+    sf::Vector2i pos = window.getPosition();
+    leaderboardWindow.setPosition({pos.x + (int)size.x / 4, pos.y + (int)size.y / 4});
+    leaderboardWindow.setVisible(true);
+    leaderboardWindow.requestFocus();
 }
 
-void DrawDigits(sf::RenderWindow& window, int number, float xOffset, int maxDigits, int rows, TextureManager& textures) {
-    sf::Sprite digitSprite(textures.GetTexture("digits.png"));
+std::string FormatPlayerStats(const std::string& name, const PlayerRecord& record) {
+    char line[160];
+    int median = (int)(record.medianSeconds.Get() + 0.5);
+    std::snprintf(line, sizeof(line), "%s: won %u of %u, streak %u (best %u)\nmedian %02d:%02d, %.2f 3BV/s\n",
+                  name.c_str(), record.wins, record.gamesPlayed, record.currentStreak, record.bestStreak,
+                  median / 60, median % 60, record.Get3BVPerSecond());
+    return line;
+}
 
-    std::string s = std::to_string(std::abs(number));
-    while (s.length() < maxDigits) {
-        s.insert(0, "0");
+void LoadAllTextures(TextureManager& textures) {
+    std::vector<std::string> fileNames;
+    for (int id = 0; id < TextureManager::TEXTURE_COUNT; ++id) {
+        fileNames.push_back(TextureManager::GetFileName(static_cast<TextureManager::TextureID>(id)));
     }
-    s = s.substr(s.length() - maxDigits);
-
-    float yPos = (float)rows * 32.0f + 16.0f;
+    textures.LoadTextures(fileNames);
+}
 
-    if (number < 0) {
-        sf::IntRect rect({210, 0}, {21, 32});
-        digitSprite.setTextureRect(rect);
-        digitSprite.setPosition({xOffset, yPos});
-        window.draw(digitSprite);
-        xOffset += 21;
+int main(int argc, char* argv[]) {
+    auto launchTime = std::chrono::high_resolution_clock::now();
+
+    // Assets are embedded in the executable; --assets <dir> loads them from disk instead.
+    std::string assetDirectory;
+    std::string metricsFile = "files/metrics.prom";
+    bool checkAllocations = false;
+    unsigned long long boardSeed = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--check-allocations") checkAllocations = true;
+        else if (arg == "--daily") boardSeed = DailySeed();
+        else if (i + 1 >= argc) break;
+        else if (arg == "--assets") assetDirectory = argv[++i];
+        else if (arg == "--metrics-file") metricsFile = argv[++i];
+        else if (arg == "--trace") Trace::Enable(argv[++i]);
     }
-
-    for (char digitChar : s) {
-        int digit = digitChar - '0';
-        sf::IntRect rect({digit * 21, 0}, {21, 32});
-        digitSprite.setTextureRect(rect);
-        digitSprite.setPosition({xOffset, yPos});
-        xOffset += 21;
-        window.draw(digitSprite);
+#ifndef MINESWEEPER_METRICS
+    if (checkAllocations) {
+        std::cerr << "Error: --check-allocations needs a build with MINESWEEPER_METRICS!" << std::endl;
+        return 1;
     }
-}
+#endif
 
-int main() {
+#ifdef MINESWEEPER_METRICS
+    MetricsExporter metricsExporter;
+    metricsExporter.Start(metricsFile, 10);
+#endif
     int columns = 0;
     int rows = 0;
     int mineCount = 0;
-    ReadConfig(columns, rows, mineCount);
+    int leaderboardSize = 0;
+    ReadConfig(columns, rows, mineCount, leaderboardSize);
 
-    unsigned int width = columns * 32;
-    unsigned int height = rows * 32 + 100;
+    // Boards larger than the display get a scrollable, zoomable camera instead of a giant window.
+    sf::Vector2u desktop = sf::VideoMode::getDesktopMode().size;
+    unsigned int width = std::min<unsigned int>(columns * 32, desktop.x * 9 / 10);
+    unsigned int height = std::min<unsigned int>(rows * 32, desktop.y * 9 / 10 - 100) + 100;
+    float boardHeight = (float)height - 100.0f;
 
     sf::RenderWindow window(sf::VideoMode({width, height}), "Minesweeper");
     window.setFramerateLimit(60);
 
+    // The font only touches the file system and FreeType, so it loads while the textures decode.
+    sf::Font font;
+    std::future<bool> fontLoaded = std::async(std::launch::async, [&font, &assetDirectory]() {
+        if (!assetDirectory.empty()) return font.openFromFile(assetDirectory + "/font.ttf");
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        return AssetPack::Embedded().Find("font.ttf", data, size) && font.openFromMemory(data, size);
+    });
+
     TextureManager textureManager;
+    textureManager.SetAssetDirectory(assetDirectory);
     LoadAllTextures(textureManager);
 
-    sf::Font font;
-    if (!font.openFromFile("files/font.ttf")) {
+    if (!fontLoaded.get()) {
         std::cerr << "Error: Could not load font.ttf!" << std::endl;
         return 1;
     }
@@ -124,34 +178,119 @@ int main() {
     std::string playerName;
 
     Board gameBoard;
-    gameBoard.Initialize(columns, rows, mineCount, textureManager);
-
-    Leaderboard leaderboard;
-    sf::RenderWindow leaderboardWindow;
+    gameBoard.SetViewport((float)width, boardHeight, (float)height);
+    gameBoard.Initialize(columns, rows, mineCount, boardSeed);
+    GameReplay replay;
+    replay.Reset(columns, rows, mineCount, gameBoard.GetSeed());
+
+    LeaderboardKey boardKey = {columns, rows, mineCount, boardSeed};
+    LeaderboardService leaderboard;
+    leaderboard.Start(boardKey, leaderboardSize, std::max(1u, std::thread::hardware_concurrency() / 2), "files/player_stats.bin");
+    bool gameRecorded = false;
+    std::string playerStatsLine;
+    sf::RenderWindow leaderboardWindow(sf::VideoMode({width / 2, height / 2}), "Minesweeper", sf::Style::Titlebar | sf::Style::Close);
+    leaderboardWindow.setVisible(false);
     bool leaderboardOpen = false;
 
+    sf::Text leaderboardContent(font);
+    leaderboardContent.setCharacterSize(18);
+    leaderboardContent.setFillColor(sf::Color::White);
+    leaderboardContent.setStyle(sf::Text::Bold);
+    unsigned long long leaderboardContentVersion = 0;
+    std::string leaderboardStatus;
+    bool leaderboardTextDirty = false;
+
     auto startTime = std::chrono::high_resolution_clock::now();
+    auto pauseStart = startTime;
     long long timeElapsed = 0;
     bool timeStopped = true;
     bool wasPausedBeforeLeaderboard = false;
+    // --check-allocations plays by itself: straight into a game with the timer running.
+    if (checkAllocations) {
+        welcomeScreen = false;
+        playerName = "Check";
+        timeStopped = false;
+    }
+    bool panning = false;
+    sf::Vector2i panOrigin;
+
+    FrameProfiler profiler;
+    profiler.Initialize(font);
 
-    sf::Sprite happyFace(textureManager.GetTexture("face_happy.png"));
-    happyFace.setPosition({width / 2.0f - 32.0f, (float)rows * 32.0f + 16.0f});
+    Hud hud;
+    hud.Initialize(textureManager.GetTexture(TextureManager::DIGITS), (float)width, boardHeight + 16.0f);
 
-    sf::Sprite debugButton(textureManager.GetTexture("debug.png"));
-    debugButton.setPosition({width - 304.0f, (float)rows * 32.0f + 16.0f});
+    sf::Sprite happyFace(textureManager.GetTexture(TextureManager::FACE_HAPPY));
+    happyFace.setPosition({width / 2.0f - 32.0f, boardHeight + 16.0f});
 
-    sf::Sprite pausePlayButton(textureManager.GetTexture("pause.png"));
-    pausePlayButton.setPosition({width - 240.0f, (float)rows * 32.0f + 16.0f});
+    sf::Sprite debugButton(textureManager.GetTexture(TextureManager::DEBUG));
+    debugButton.setPosition({width - 304.0f, boardHeight + 16.0f});
 
-    sf::Sprite leaderboardButton(textureManager.GetTexture("leaderboard.png"));
-    leaderboardButton.setPosition({width - 176.0f, (float)rows * 32.0f + 16.0f});
+    sf::Sprite pausePlayButton(textureManager.GetTexture(TextureManager::PAUSE));
+    pausePlayButton.setPosition({width - 240.0f, boardHeight + 16.0f});
+
+    sf::Sprite leaderboardButton(textureManager.GetTexture(TextureManager::LEADERBOARD));
+    leaderboardButton.setPosition({width - 176.0f, boardHeight + 16.0f});
+
+    bool needsRedraw = true;
+    bool firstFrameShown = false;
+    unsigned long long framesDrawn = 0;
+    bool windowFocused = true;
+    sf::Clock frameClock;
 
     while (window.isOpen()) {
-        while (const std::optional event = window.pollEvent()) {
+        // The check redraws flat out, focused or not, so it gets through its frames quickly.
+        if (checkAllocations) {
+            needsRedraw = true;
+            windowFocused = true;
+        }
+        bool timerRunning = !welcomeScreen && !timeStopped && gameBoard.currentState == Board::PLAYING;
+        bool throttled = !windowFocused && frameClock.getElapsedTime() < UNFOCUSED_FRAME_INTERVAL;
+
+        std::optional<sf::Event> event;
+        if (needsRedraw && !throttled) {
+            event = window.pollEvent();
+        } else {
+            sf::Time timeout = sf::Time::Zero;
+            if (timerRunning) {
+                auto sinceStart = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+                timeout = ShorterTimeout(timeout, sf::milliseconds(1000 - (int)(sinceStart % 1000)));
+            }
+            if (leaderboardOpen) {
+                timeout = ShorterTimeout(timeout, LEADERBOARD_POLL_INTERVAL);
+            }
+            if (needsRedraw) {
+                timeout = ShorterTimeout(timeout, UNFOCUSED_FRAME_INTERVAL - frameClock.getElapsedTime());
+            }
+            event = window.waitEvent(timeout);
+        }
+        profiler.BeginFrame();
+        AllocationStats actionStart = AllocationTracker::ThreadStats();
+        bool inputHandled = false;
+
+        for (; event; event = window.pollEvent()) {
+            if (event->is<sf::Event::MouseMoved>() && !panning) continue;
+            needsRedraw = true;
+            inputHandled = true;
+
             if (event->is<sf::Event::Closed>()) {
                 window.close();
             }
+            else if (event->is<sf::Event::FocusLost>()) {
+                windowFocused = false;
+            }
+            else if (event->is<sf::Event::FocusGained>()) {
+                windowFocused = true;
+            }
+
+            if (const auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
+                if (keyEvent->code == sf::Keyboard::Key::F3) {
+                    profiler.ToggleOverlay();
+                }
+                else if (keyEvent->code == sf::Keyboard::Key::F4 && !profiler.DumpCsv("frame_profile.csv")) {
+                    std::cerr << "Error: Could not write frame_profile.csv!" << std::endl;
+                }
+            }
 
             if (welcomeScreen) {
                 if (const auto* textEvent = event->getIf<sf::Event::TextEntered>()) {
@@ -180,7 +319,31 @@ int main() {
                     }
                 }
             } else {
-                if (const auto* mouseEvent = event->getIf<sf::Event::MouseButtonPressed>()) {
+                if (const auto* wheelEvent = event->getIf<sf::Event::MouseWheelScrolled>()) {
+                    if (wheelEvent->wheel == sf::Mouse::Wheel::Vertical && (float)wheelEvent->position.y < boardHeight) {
+                        gameBoard.Zoom(wheelEvent->delta > 0 ? 0.8f : 1.25f, (float)wheelEvent->position.x, (float)wheelEvent->position.y);
+                    }
+                }
+                else if (const auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
+                    if (keyEvent->code == sf::Keyboard::Key::Left) gameBoard.Pan(-64.0f, 0.0f);
+                    else if (keyEvent->code == sf::Keyboard::Key::Right) gameBoard.Pan(64.0f, 0.0f);
+                    else if (keyEvent->code == sf::Keyboard::Key::Up) gameBoard.Pan(0.0f, -64.0f);
+                    else if (keyEvent->code == sf::Keyboard::Key::Down) gameBoard.Pan(0.0f, 64.0f);
+                    else if (keyEvent->code == sf::Keyboard::Key::Home) gameBoard.ResetView();
+                }
+                else if (const auto* moveEvent = event->getIf<sf::Event::MouseMoved>()) {
+                    gameBoard.Pan((float)(panOrigin.x - moveEvent->position.x), (float)(panOrigin.y - moveEvent->position.y));
+                    panOrigin = moveEvent->position;
+                }
+                else if (const auto* releaseEvent = event->getIf<sf::Event::MouseButtonReleased>()) {
+                    if (releaseEvent->button == sf::Mouse::Button::Middle) panning = false;
+                }
+                else if (const auto* mouseEvent = event->getIf<sf::Event::MouseButtonPressed>()) {
+                    if (mouseEvent->button == sf::Mouse::Button::Middle) {
+                        panning = true;
+                        panOrigin = mouseEvent->position;
+                        continue;
+                    }
                     sf::Vector2f mousePos = (sf::Vector2f)sf::Mouse::getPosition(window);
 
                     bool clickedHappyFace = happyFace.getGlobalBounds().contains(mousePos);
@@ -189,10 +352,12 @@ int main() {
                     bool clickedLeaderboard = leaderboardButton.getGlobalBounds().contains(mousePos);
 
                     if (clickedHappyFace) {
-                        gameBoard.Restart(textureManager);
+                        gameBoard.Restart();
+                        replay.Reset(columns, rows, mineCount, gameBoard.GetSeed());
+                        gameRecorded = false;
                         timeStopped = false;
                         startTime = std::chrono::high_resolution_clock::now();
-                        pausePlayButton.setTexture(textureManager.GetTexture("pause.png"));
+                        pausePlayButton.setTexture(textureManager.GetTexture(TextureManager::PAUSE));
                     }
                     else if (gameBoard.currentState == Board::PLAYING) {
                         if (clickedDebug && !timeStopped) {
@@ -201,34 +366,44 @@ int main() {
                         else if (clickedPause) {
                             timeStopped = !timeStopped;
                             if (timeStopped) {
-                                pausePlayButton.setTexture(textureManager.GetTexture("play.png"));
+                                pausePlayButton.setTexture(textureManager.GetTexture(TextureManager::PLAY));
+                                pauseStart = std::chrono::high_resolution_clock::now();
                             } else {
-                                pausePlayButton.setTexture(textureManager.GetTexture("pause.png"));
-                                startTime = std::chrono::high_resolution_clock::now() - std::chrono::seconds(timeElapsed);
+                                pausePlayButton.setTexture(textureManager.GetTexture(TextureManager::PAUSE));
+                                startTime += std::chrono::high_resolution_clock::now() - pauseStart;
                             }
                         }
                         else if (clickedLeaderboard) {
                             wasPausedBeforeLeaderboard = timeStopped;
+                            if (!timeStopped) pauseStart = std::chrono::high_resolution_clock::now();
                             timeStopped = true;
                             leaderboardOpen = true;
-                            leaderboardWindow.create(sf::VideoMode({width / 2, height / 2}), "Minesweeper", sf::Style::Titlebar | sf::Style::Close);
-                            sf::Vector2i pos = window.getPosition();
-                            leaderboardWindow.setPosition({pos.x + (int)width / 4, pos.y + (int)height / 4});
+                            ShowLeaderboardWindow(leaderboardWindow, window);
                         }
-                        else if (mousePos.y < (float)rows * 32.0f && !timeStopped && !leaderboardOpen) {
-                            if (mouseEvent->button == sf::Mouse::Button::Left) {
-                                gameBoard.LeftClickTile(mousePos.x, mousePos.y);
+                        else if (mousePos.y < boardHeight && !timeStopped && !leaderboardOpen) {
+                            // Every click is logged in game time so the score can be replayed later.
+                            int cell = gameBoard.GetCellAt(mousePos.x, mousePos.y);
+                            auto gameTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+                            if (cell >= 0 && mouseEvent->button == sf::Mouse::Button::Left) {
+                                replay.Record((uint32_t)gameTime, cell, REPLAY_REVEAL);
+                                gameBoard.RevealCell(cell);
                             }
-                            else if (mouseEvent->button == sf::Mouse::Button::Right) {
-                                gameBoard.RightClickTile(mousePos.x, mousePos.y);
+                            else if (cell >= 0 && mouseEvent->button == sf::Mouse::Button::Right) {
+                                replay.Record((uint32_t)gameTime, cell, REPLAY_FLAG);
+                                gameBoard.ToggleFlag(cell);
+                            }
+                            // The timer below stops once the game is over, so the final time
+                            // has to come from the click that ended it, the same one the
+                            // replay verifier sees.
+                            if (gameBoard.currentState != Board::PLAYING) {
+                                timeElapsed = std::min<long long>(gameTime / 1000, 99 * 60 + 59);
+                                needsRedraw = true;
                             }
                         }
                     }
                     else if (clickedLeaderboard) {
                          leaderboardOpen = true;
-                         leaderboardWindow.create(sf::VideoMode({width / 2, height / 2}), "Minesweeper", sf::Style::Titlebar | sf::Style::Close);
-                         sf::Vector2i pos = window.getPosition();
-                         leaderboardWindow.setPosition({pos.x + (int)width / 4, pos.y + (int)height / 4});
+                         ShowLeaderboardWindow(leaderboardWindow, window);
                     }
                 }
             }
@@ -236,83 +411,168 @@ int main() {
 
         if (leaderboardOpen) {
             while (const std::optional lbEvent = leaderboardWindow.pollEvent()) {
+                if (lbEvent->is<sf::Event::MouseMoved>()) continue;
+                needsRedraw = true;
                 if (lbEvent->is<sf::Event::Closed>()) {
                     leaderboardOpen = false;
-                    leaderboardWindow.close();
+                    leaderboardWindow.setVisible(false);
 
                     if (gameBoard.currentState == Board::PLAYING && !wasPausedBeforeLeaderboard) {
                         timeStopped = false;
-                        startTime = std::chrono::high_resolution_clock::now() - std::chrono::seconds(timeElapsed);
-                        pausePlayButton.setTexture(textureManager.GetTexture("pause.png"));
+                        startTime += std::chrono::high_resolution_clock::now() - pauseStart;
+                        pausePlayButton.setTexture(textureManager.GetTexture(TextureManager::PAUSE));
                     }
                 }
             }
         }
 
+        // The I/O thread publishes a new snapshot whenever scores land, ours or another instance's.
+        leaderboard.PollCompletions();
+        if (leaderboardOpen && leaderboard.GetSnapshot()->version != leaderboardContentVersion) needsRedraw = true;
+
+        profiler.Mark(FrameProfiler::EVENTS);
+
         if (!timeStopped && gameBoard.currentState == Board::PLAYING) {
             auto currentTime = std::chrono::high_resolution_clock::now();
+            long long previousElapsed = timeElapsed;
             timeElapsed = std::chrono::duration_cast<std::chrono::seconds>(currentTime - startTime).count();
             if (timeElapsed > 99 * 60 + 59) {
                 timeElapsed = 99 * 60 + 59;
             }
+            if (timeElapsed != previousElapsed) needsRedraw = true;
+        }
+
+        // Per-player aggregates are updated once per game, as it leaves PLAYING. The record is
+        // written on the leaderboard's I/O thread, since it takes a file lock and may reread
+        // records other instances appended.
+        if (gameBoard.currentState != Board::PLAYING && !gameRecorded) {
+            gameRecorded = true;
+            bool won = (gameBoard.currentState == Board::WIN);
+            leaderboard.RecordGame(playerName, won, (int)timeElapsed, won ? gameBoard.Calculate3BV() : 0, [&, name = playerName](const PlayerStatsResult& result) {
+                if (!result.saved) return;
+                playerStatsLine = FormatPlayerStats(name, result.record);
+                leaderboardTextDirty = true;
+                needsRedraw = true;
+            });
         }
 
         if (gameBoard.currentState == Board::WIN && !leaderboardOpen && !gameBoard.leaderboardShown) {
              gameBoard.leaderboardShown = true;
+             needsRedraw = true;
              timeStopped = true;
-             leaderboard.UpdateLeaderboard(playerName, timeElapsed);
+             size_t provisionalRank = leaderboard.Submit(playerName, (int)timeElapsed, std::move(replay), [&](const LeaderboardResult& result) {
+                 if (result.verdict != REPLAY_ACCEPTED) {
+                     leaderboardStatus = std::string("Replay rejected: ") + DescribeVerdict(result.verdict) + "\n";
+                 } else {
+                     leaderboardStatus = result.saved ? "" : "Could not save your score!\n";
+                 }
+                 leaderboardTextDirty = true;
+                 needsRedraw = true;
+             });
+             leaderboardStatus = "Saving... rank #" + std::to_string(provisionalRank) + "\n";
+             leaderboardTextDirty = true;
              leaderboardOpen = true;
-             leaderboardWindow.create(sf::VideoMode({width / 2, height / 2}), "Minesweeper", sf::Style::Titlebar | sf::Style::Close);
-             sf::Vector2i pos = window.getPosition();
-             leaderboardWindow.setPosition({pos.x + (int)width / 4, pos.y + (int)height / 4});
+             ShowLeaderboardWindow(leaderboardWindow, window);
+        }
+
+        profiler.Mark(FrameProfiler::UPDATE);
+
+        if (inputHandled) {
+            [[maybe_unused]] AllocationStats actionAllocations = AllocationTracker::Since(actionStart);
+            METRIC_ADD(ACTION_ALLOCATIONS, actionAllocations.allocations);
+            METRIC_ADD(ACTION_ALLOCATED_BYTES, actionAllocations.bytes);
         }
 
+        if (!needsRedraw || (!windowFocused && frameClock.getElapsedTime() < UNFOCUSED_FRAME_INTERVAL)) {
+            continue;
+        }
+        needsRedraw = false;
+        frameClock.restart();
+        AllocationStats frameStart = AllocationTracker::ThreadStats();
+
         if (welcomeScreen) {
             window.clear(sf::Color::Blue);
             window.draw(welcomeText);
             window.draw(promptText);
             window.draw(inputText);
+            // The welcome screen takes the board's place.
+            profiler.Mark(FrameProfiler::BOARD_DRAW);
         } else {
             window.clear(sf::Color::White);
 
             bool forceRevealed = (leaderboardOpen || (timeStopped && gameBoard.currentState == Board::PLAYING));
             gameBoard.Draw(window, forceRevealed, textureManager);
+            profiler.Mark(FrameProfiler::BOARD_DRAW);
 
             sf::Sprite currentFace = happyFace;
             if (gameBoard.currentState == Board::WIN) {
-                currentFace.setTexture(textureManager.GetTexture("face_win.png"));
+                currentFace.setTexture(textureManager.GetTexture(TextureManager::FACE_WIN));
             } else if (gameBoard.currentState == Board::LOSE) {
-                currentFace.setTexture(textureManager.GetTexture("face_lose.png"));
+                currentFace.setTexture(textureManager.GetTexture(TextureManager::FACE_LOSE));
             }
             window.draw(currentFace);
             window.draw(debugButton);
             window.draw(pausePlayButton);
             window.draw(leaderboardButton);
+            METRIC_ADD(DRAW_CALLS, 4);
+            METRIC_ADD(VERTICES, 16);
 
-            int mineCounter = gameBoard.GetTotalMines() - gameBoard.flagsPlaced;
-            DrawDigits(window, mineCounter, 33.0f, 3, rows, textureManager);
-
-            int minutes = (int)(timeElapsed / 60);
-            int seconds = (int)(timeElapsed % 60);
-            DrawDigits(window, minutes, width - 97.0f, 2, rows, textureManager);
-            DrawDigits(window, seconds, width - 54.0f, 2, rows, textureManager);
+            hud.SetMineCounter(gameBoard.GetTotalMines() - gameBoard.flagsPlaced);
+            hud.SetTime(timeElapsed);
+            window.draw(hud);
+            METRIC_DRAW(48);
+            profiler.Mark(FrameProfiler::HUD);
 
             if (leaderboardOpen) {
                 leaderboardWindow.clear(sf::Color::Blue);
-                sf::Text leaderboardContent(font);
-                leaderboardContent.setString(leaderboard.GetFormattedContent());
-                leaderboardContent.setCharacterSize(18);
-                leaderboardContent.setFillColor(sf::Color::White);
-                leaderboardContent.setStyle(sf::Text::Bold);
-
-                setText(leaderboardContent, width / 4.0f, height / 4.0f);
+                std::shared_ptr<const LeaderboardSnapshot> snapshot = leaderboard.GetSnapshot();
+                if (leaderboardContentVersion != snapshot->version || leaderboardTextDirty) {
+                    leaderboardContentVersion = snapshot->version;
+                    leaderboardTextDirty = false;
+                    leaderboardContent.setString(snapshot->content + leaderboardStatus + playerStatsLine);
+                    setText(leaderboardContent, width / 4.0f, height / 4.0f);
+                }
 
                 leaderboardWindow.draw(leaderboardContent);
                 leaderboardWindow.display();
+                profiler.Mark(FrameProfiler::LEADERBOARD_WINDOW);
             }
         }
+
+        profiler.UpdateOverlay();
+        window.draw(profiler);
+        profiler.Mark(FrameProfiler::OVERLAY);
+
         window.display();
+        METRIC_ADD(FRAMES, 1);
+        framesDrawn++;
+
+        // Frames redrawn only because the timer ticked must not touch the heap.
+        AllocationStats frameAllocations = AllocationTracker::Since(frameStart);
+        METRIC_ADD(FRAME_ALLOCATIONS, frameAllocations.allocations);
+        METRIC_ADD(FRAME_ALLOCATED_BYTES, frameAllocations.bytes);
+        if (checkAllocations && !inputHandled && !profiler.IsOverlayVisible() && framesDrawn > ALLOCATION_CHECK_WARMUP_FRAMES && frameAllocations.allocations > 0) {
+            std::cerr << "Error: Steady-state frame " << framesDrawn << " made " << frameAllocations.allocations
+                      << " heap allocations (" << frameAllocations.bytes << " bytes)!" << std::endl;
+            return 1;
+        }
+        if (checkAllocations && framesDrawn >= ALLOCATION_CHECK_FRAMES) {
+            std::cout << "No heap allocations in " << framesDrawn - ALLOCATION_CHECK_WARMUP_FRAMES << " steady-state frames" << std::endl;
+            window.close();
+        }
+        profiler.Mark(FrameProfiler::DISPLAY);
+        profiler.EndFrame();
+
+        if (!firstFrameShown) {
+            firstFrameShown = true;
+            auto firstFrame = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - launchTime).count();
+            std::cout << "Time to first frame: " << firstFrame << " ms" << std::endl;
+        }
     }
 
+    leaderboard.Stop();
+    if (!Trace::Flush()) {
+        std::cerr << "Error: Could not write the trace file!" << std::endl;
+    }
     return 0;
 }
\ No newline at end of file